@@ -0,0 +1,615 @@
+/**
+ * Graph benchmarks
+ * Build: g++ -std=c++20 -O3 -march=native -pthread Benchmark.cpp -o bench
+ * Usage: bench [floyd vertex count] [thread count] [social vertex count]
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cstddef>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <bit>
+#include "Graph.hpp"
+#include "Generators.hpp"
+#include "Snapshot.hpp"
+
+using namespace dsl::graph;
+
+typedef std::chrono::steady_clock clock_type;
+
+template<class Fn>
+size_t timeMs(Fn&& fn) {
+    auto start = clock_type::now();
+    fn();
+    auto end = clock_type::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        end - start
+    ).count();
+}
+
+typedef SimpleGraph<
+    size_t, int, true, size_t,
+    MatrixStorage<size_t, int, true>
+> MatrixGraph;
+
+void randomGraph(MatrixGraph& g, size_t vertex, double density) {
+    std::mt19937_64 engine(20240520);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> weight(1, 1000);
+    for (size_t i = 0; i < vertex; ++i) g.emplaceNode(i);
+    for (size_t i = 0; i < vertex; ++i) {
+        for (size_t j = 0; j < vertex; ++j) {
+            if (i != j && coin(engine) < density) g.addEdge(i, j, weight(engine));
+        }
+    }
+}
+
+// textbook triple loop over a vector of rows
+std::vector<std::vector<int>> naiveFloyd(const MatrixGraph& g, size_t vertex) {
+    constexpr int inf = algorithms::DistanceMatrix<int>::unreachable;
+    std::vector<std::vector<int>> dist(vertex, std::vector<int>(vertex, inf));
+    for (size_t i = 0; i < vertex; ++i) {
+        for (size_t j = 0; j < vertex; ++j) {
+            if (i == j) dist[i][j] = 0;
+            else if (g.getWeight(i, j) != MatrixGraph::nweight) {
+                dist[i][j] = g.getWeight(i, j);
+            }
+        }
+    }
+    for (size_t k = 0; k < vertex; ++k) {
+        for (size_t i = 0; i < vertex; ++i) {
+            for (size_t j = 0; j < vertex; ++j) {
+                if (dist[i][k] + dist[k][j] < dist[i][j]) {
+                    dist[i][j] = dist[i][k] + dist[k][j];
+                }
+            }
+        }
+    }
+    return dist;
+}
+
+void benchFloyd(size_t vertex, size_t threads) {
+    MatrixGraph g;
+    randomGraph(g, vertex, 0.05);
+
+    std::vector<std::vector<int>> naive;
+    algorithms::DistanceMatrix<int> single, multi;
+    size_t naive_ms = timeMs([&] { naive = naiveFloyd(g, vertex); });
+    size_t single_ms = timeMs([&] { single = algorithms::Floyd(g, 1); });
+    size_t multi_ms = timeMs([&] { multi = algorithms::Floyd(g, threads); });
+
+    size_t mismatch = 0;
+    for (size_t i = 0; i < vertex; ++i) {
+        for (size_t j = 0; j < vertex; ++j) {
+            if (naive[i][j] != single.at(i, j)) ++mismatch;
+            if (naive[i][j] != multi.at(i, j)) ++mismatch;
+        }
+    }
+
+    std::cout << "Floyd on " << vertex << " vertices\n"
+        << "  naive triple loop:  " << naive_ms << " ms\n"
+        << "  blocked, 1 thread:  " << single_ms << " ms\n"
+        << "  blocked, " << threads << " threads: " << multi_ms << " ms\n"
+        << "  mismatches: " << mismatch << '\n';
+}
+
+typedef SimpleGraph<
+    size_t, int, true, size_t,
+    FlatMatrixStorage<size_t, int, true>
+> FlatGraph;
+
+// vertex insertion and a full row scan, row-per-vector against one buffer;
+// each new vertex links both ways to vertex i / 2, and every edge must survive the growth
+void benchMatrixGrowth(size_t vertex) {
+    MatrixGraph nested;
+    FlatGraph flat;
+    auto grow = [vertex](auto& g) {
+        for (size_t i = 0; i < vertex; ++i) {
+            g.emplaceNode(i);
+            if (i == 0) continue;
+            g.addEdge(i, i / 2, static_cast<int>(i));
+            g.addEdge(i / 2, i, static_cast<int>(i));
+        }
+    };
+    size_t nested_ms = timeMs([&] { grow(nested); });
+    size_t flat_ms = timeMs([&] { grow(flat); });
+    size_t nested_count = 0, flat_count = 0;
+    size_t nested_scan = timeMs([&] {
+        for (size_t i = 0; i < vertex; ++i) nested_count += nested.const_access(i).forth().raw().count();
+    });
+    size_t flat_scan = timeMs([&] {
+        for (size_t i = 0; i < vertex; ++i) flat_count += flat.const_access(i).forth().raw().count();
+    });
+
+    size_t expected = vertex == 0 ? 0 : 2 * (vertex - 1);
+    size_t mismatch = (nested_count != expected) + (flat_count != expected);
+    for (size_t i = 1; i < vertex; ++i) {
+        mismatch += nested.getWeight(i, i / 2) != static_cast<int>(i);
+        mismatch += nested.getWeight(i / 2, i) != static_cast<int>(i);
+        mismatch += flat.getWeight(i, i / 2) != static_cast<int>(i);
+        mismatch += flat.getWeight(i / 2, i) != static_cast<int>(i);
+    }
+    // writing the null weight over an edge removes it
+    if (vertex > 1) {
+        size_t degree = flat.const_access(1).forth().raw().count();
+        flat.addEdge(1, 0, 0);
+        mismatch += flat.storage().size() != expected - 1;
+        mismatch += flat.const_access(1).forth().raw().count() != degree - 1;
+    }
+
+    std::cout << "Matrix growth to " << vertex << " vertices\n"
+        << "  MatrixStorage:     insert " << nested_ms << " ms, scan " << nested_scan << " ms\n"
+        << "  FlatMatrixStorage: insert " << flat_ms << " ms, scan " << flat_scan << " ms\n"
+        << "  mismatches: " << mismatch << '\n';
+}
+
+typedef SimpleGraph<
+    size_t, int, false, size_t,
+    CsrStorage<size_t, int, false>
+> SocialGraph;
+
+// point-to-point queries: one-sided BFS against bidirectional BFS
+void benchPointToPoint(size_t vertex, size_t queries) {
+    SocialGraph g;
+    std::mt19937_64 engine(20240521);
+    std::uniform_int_distribution<size_t> pick(0, vertex - 1);
+    for (size_t i = 0; i < vertex; ++i) g.emplaceNode(i);
+    for (size_t i = 0; i < vertex * 4; ++i) g.addEdge(pick(engine), pick(engine), 1);
+    g.storage().freeze();
+
+    size_t bfs_expanded = 0, bi_expanded = 0, mismatch = 0;
+    size_t bfs_ms = 0, bi_ms = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        size_t from = pick(engine), to = pick(engine);
+        bfs_ms += timeMs([&] {
+            algorithms::BFS(g.const_access(from), [&](const size_t& v) {
+                ++bfs_expanded;
+                return v != to;
+            });
+        });
+        algorithms::SearchPath<size_t> path;
+        bi_ms += timeMs([&] {
+            path = algorithms::BidirectionalBFS(g.const_access(from), g.const_access(to));
+        });
+        bi_expanded += path.expanded;
+        auto levels = algorithms::ParallelBFS(g, from, to, 1);
+        if (levels.reached(to) != path.found()) ++mismatch;
+        else if (path.found() && levels.distance[to] != path.length()) ++mismatch;
+    }
+
+    std::cout << "Point-to-point on " << vertex << " vertices, "
+        << queries << " queries\n"
+        << "  BFS:               " << bfs_ms << " ms, "
+        << bfs_expanded << " nodes expanded\n"
+        << "  bidirectional BFS: " << bi_ms << " ms, "
+        << bi_expanded << " nodes expanded\n"
+        << "  mismatches: " << mismatch << '\n';
+}
+
+typedef SimpleGraph<size_t, int, false> HashGraph;
+
+// edge-at-a-time insertion against bulkLoad on the default storage
+void benchIngest(size_t vertex, size_t edges, size_t threads) {
+    std::mt19937_64 engine(20240522);
+    std::uniform_int_distribution<size_t> pick(0, vertex - 1);
+    std::vector<HashGraph::edge_type> list;
+    list.reserve(edges);
+    for (size_t i = 0; i < edges; ++i) list.emplace_back(pick(engine), pick(engine), 1);
+
+    HashGraph single, bulk;
+    for (size_t i = 0; i < vertex; ++i) {
+        single.emplaceNode(i);
+        bulk.emplaceNode(i);
+    }
+    size_t single_ms = timeMs([&] {
+        for (auto& [from, to, weight]: list) single.addEdge(from, to, weight);
+    });
+    auto stats = bulk.bulkLoad(list, threads);
+
+    std::cout << "Ingest " << edges << " edges on " << vertex << " vertices\n"
+        << "  addEdge:  " << single_ms << " ms\n"
+        << "  bulkLoad: " << static_cast<size_t>(stats.seconds() * 1000) << " ms (sort "
+        << static_cast<size_t>(stats.sort_seconds * 1000) << " ms, build "
+        << static_cast<size_t>(stats.build_seconds * 1000) << " ms), "
+        << static_cast<size_t>(stats.throughput()) << " edges/s, "
+        << stats.loaded << " unique\n";
+}
+
+typedef SimpleGraph<
+    size_t, int, false, size_t,
+    CsrStorage<size_t, int, false>
+> GridGraph;
+
+// every grid edge weighs at least 1 and moves one cell, so the distance is consistent
+struct GridManhattan {
+    static constexpr bool consistent = true;
+    size_t side;
+    int operator()(size_t a, size_t b) const {
+        size_t dx = a % side > b % side ? a % side - b % side : b % side - a % side;
+        size_t dy = a / side > b / side ? a / side - b / side : b / side - a / side;
+        return static_cast<int>(dx + dy);
+    }
+};
+
+// goal-directed search on a side x side grid: Manhattan A* against a zero heuristic
+void benchAStar(size_t side, size_t queries) {
+    GridGraph g;
+    std::mt19937_64 engine(20240524);
+    std::uniform_int_distribution<int> weight(1, 10);
+    std::uniform_int_distribution<size_t> pick(0, side * side - 1);
+    for (size_t i = 0; i < side * side; ++i) g.emplaceNode(i);
+    for (size_t y = 0; y < side; ++y) {
+        for (size_t x = 0; x < side; ++x) {
+            size_t i = y * side + x;
+            if (x + 1 < side) g.addEdge(i, i + 1, weight(engine));
+            if (y + 1 < side) g.addEdge(i, i + side, weight(engine));
+        }
+    }
+    g.storage().freeze();
+
+    GridManhattan manhattan{side};
+    auto zero = [](size_t, size_t) { return 0; };
+    algorithms::AStarWorkspace<size_t, int> workspace;
+    size_t astar_expanded = 0, zero_expanded = 0, astar_ms = 0, zero_ms = 0, mismatch = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        size_t from = pick(engine), to = pick(engine);
+        algorithms::AStarPath<size_t, int> directed, blind;
+        astar_ms += timeMs([&] {
+            directed = algorithms::AStar(g.const_access(from), g.const_access(to), manhattan, workspace);
+        });
+        zero_ms += timeMs([&] {
+            blind = algorithms::AStar(g.const_access(from), g.const_access(to), zero, workspace);
+        });
+        astar_expanded += directed.expanded;
+        zero_expanded += blind.expanded;
+        if (directed.distance != blind.distance) ++mismatch;
+    }
+
+    std::cout << "A* on a " << side << " x " << side << " grid, "
+        << queries << " queries\n"
+        << "  Manhattan heuristic: " << astar_ms << " ms, "
+        << astar_expanded << " nodes expanded\n"
+        << "  zero heuristic:      " << zero_ms << " ms, "
+        << zero_expanded << " nodes expanded\n"
+        << "  mismatches: " << mismatch << '\n';
+}
+
+typedef SimpleGraph<
+    size_t, int, true, size_t,
+    ConcurrentStorage<HashListStorage<size_t, int, true, true>>,
+    ConcurrentIndexProvider<DefaultIndexProvider<size_t, size_t>>
+> SharedGraph;
+
+// adjacency lookups from 1..threads readers while one writer adds and removes edges
+void benchConcurrentReads(size_t vertex, size_t threads) {
+    SharedGraph g;
+    std::mt19937_64 engine(20240525);
+    std::uniform_int_distribution<size_t> pick(0, vertex - 1);
+    for (size_t i = 0; i < vertex; ++i) g.emplaceNode(i);
+    for (size_t i = 0; i < vertex * 8; ++i) g.addEdge(pick(engine), pick(engine), 1);
+
+    std::cout << "Concurrent reads on " << vertex << " vertices, one writer\n";
+    for (size_t readers = 1; readers <= threads; readers *= 2) {
+        std::atomic<bool> stop(false);
+        std::atomic<size_t> lookups(0), written(0);
+        std::thread writer([&] {
+            std::mt19937_64 local(7);
+            size_t count = 0;
+            // churn in place so small graphs do not fill up while readers run
+            while (!stop.load(std::memory_order_relaxed)) {
+                size_t from = pick(local), to = pick(local);
+                g.addEdge(from, to, 2);
+                g.removeEdge(from, to);
+                ++count;
+            }
+            written += count;
+        });
+        std::vector<std::thread> pool;
+        size_t ms = timeMs([&] {
+            for (size_t r = 0; r < readers; ++r) {
+                pool.emplace_back([&, r] {
+                    std::mt19937_64 local(r);
+                    std::vector<std::pair<size_t, int*>> adjacent;
+                    for (size_t i = 0; i < 200000; ++i) {
+                        adjacent.clear();
+                        g.storage().getForth(pick(local), adjacent);
+                    }
+                    lookups += 200000;
+                });
+            }
+            for (auto& t: pool) t.join();
+        });
+        stop = true;
+        writer.join();
+        std::cout << "  " << readers << " readers: "
+            << lookups.load() / std::max<size_t>(ms, 1) << " lookups/ms, "
+            << written.load() << " edges written\n";
+    }
+}
+
+typedef SimpleGraph<
+    size_t, int, true, size_t,
+    ConcurrentStorage<FlatHashStorage<size_t, int, true, true>>,
+    ConcurrentIndexProvider<DefaultIndexProvider<size_t, size_t>>
+> SharedFlatGraph;
+
+// readers walk hub 0 while one writer grows and shrinks its row across every representation;
+// edge (0, v) always weighs v + 1, so any other weight is a torn or dangling read
+void benchConcurrentHub(size_t degree, size_t threads) {
+    SharedFlatGraph g;
+    for (size_t i = 0; i <= degree; ++i) g.emplaceNode(i);
+
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> walks(0), seen(0), mismatch(0), rounds(0);
+    std::thread writer([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (size_t v = 1; v <= degree; ++v) g.addEdge(0, v, static_cast<int>(v + 1));
+            for (size_t v = degree; v >= 1; --v) g.removeEdge(0, v);
+            ++rounds;
+        }
+    });
+    std::vector<std::thread> pool;
+    size_t readers = std::max<size_t>(threads, 1);
+    size_t ms = timeMs([&] {
+        for (size_t r = 0; r < readers; ++r) {
+            pool.emplace_back([&] {
+                size_t count = 0, bad = 0;
+                for (size_t i = 0; i < 20000; ++i) {
+                    for (auto [v, wp]: g.storage().forthRange(0)) {
+                        bad += *wp != static_cast<int>(v + 1);
+                        ++count;
+                    }
+                }
+                walks += 20000;
+                seen += count;
+                mismatch += bad;
+            });
+        }
+        for (auto& t: pool) t.join();
+    });
+    stop = true;
+    writer.join();
+
+    std::cout << "Concurrent hub row, degree up to " << degree << ", "
+        << readers << " readers, one writer\n"
+        << "  " << walks.load() / std::max<size_t>(ms, 1) << " walks/ms, "
+        << seen.load() << " edges read, " << rounds.load() << " writer rounds\n"
+        << "  mismatches: " << mismatch.load() << '\n';
+}
+
+// string key lookups through find: unordered_map reverse map, interned table, frozen table
+void benchKeyLookup(size_t vertex) {
+    typedef SimpleGraph<std::string, int, true> KeyedGraph;
+    typedef SimpleGraph<
+        std::string, int, true, size_t,
+        HashListStorage<size_t, int, true>,
+        InternedIndexProvider<std::string, size_t>
+    > InternedGraph;
+    std::vector<std::string> names(vertex);
+    for (size_t i = 0; i < vertex; ++i) names[i] = "user_" + std::to_string(i * 2654435761u);
+    std::mt19937_64 engine(20240526);
+    std::uniform_int_distribution<size_t> pick(0, vertex - 1);
+    std::vector<std::string> probes(vertex * 8);
+    for (size_t i = 0; i < probes.size(); ++i) {
+        probes[i] = i % 8 == 0 ? "absent_" + std::to_string(i) : names[pick(engine)];
+    }
+
+    KeyedGraph plain;
+    InternedGraph interned;
+    size_t plain_build = timeMs([&] { for (auto& n: names) plain.addNode(n); });
+    size_t interned_build = timeMs([&] { for (auto& n: names) interned.addNode(n); });
+    size_t hits = 0;
+    auto lookup = [&](auto& g) {
+        return timeMs([&] { for (auto& p: probes) hits += g.find(p) != g.nindex; });
+    };
+    size_t plain_ms = lookup(plain), interned_ms = lookup(interned);
+    size_t freeze_ms = timeMs([&] { interned.indexProvider().freeze(); });
+    size_t frozen_ms = lookup(interned);
+
+    std::cout << "Key lookup, " << vertex << " string keys, " << probes.size() << " probes\n"
+        << "  unordered_map: build " << plain_build << " ms, find " << plain_ms << " ms\n"
+        << "  interned:      build " << interned_build << " ms, find " << interned_ms << " ms\n"
+        << "  frozen:        freeze " << freeze_ms << " ms, find " << frozen_ms << " ms\n"
+        << "  hits: " << hits / 3 << '\n';
+}
+
+// save -> load -> compare through a snapshot file; truncated or corrupt copies must be rejected
+void benchSnapshot(size_t vertex) {
+    typedef SimpleGraph<
+        std::string, int, true, size_t,
+        HashListStorage<size_t, int, true, true>
+    > NamedGraph;
+    typedef snapshot::MappedGraph<std::string, int, true> LoadedGraph;
+    std::mt19937_64 engine(20240528);
+    std::uniform_int_distribution<size_t> pick(0, vertex - 1);
+    NamedGraph g;
+    for (size_t i = 0; i < vertex; ++i) g.addNode("user_" + std::to_string(i));
+    for (size_t i = 0; i < vertex * 8; ++i) {
+        g.addEdge(pick(engine), pick(engine), static_cast<int>(i % 100));
+    }
+    // holes in the index space are renumbered by save
+    for (size_t i = 0; i < vertex; i += 97) g.removeNode(i);
+
+    std::string path = std::filesystem::temp_directory_path() / "dsl_graph_bench.snapshot";
+    size_t save_ms = timeMs([&] { snapshot::save(g, path); });
+    LoadedGraph loaded;
+    size_t load_ms = timeMs([&] { snapshot::load(loaded, path); });
+
+    auto indexes = g.allIndexes();
+    std::sort(indexes.begin(), indexes.end());
+    size_t edges = 0;
+    for (auto idx: indexes) edges += g.storage().forthRange(idx).count();
+    size_t mismatch = loaded.countVertex() != indexes.size() || loaded.countEdge() != edges;
+    std::vector<std::pair<std::string, int>> expected, actual;
+    auto adjacency = [](const auto& graph, const auto& range, auto& contain) {
+        contain.clear();
+        for (auto [v, wp]: range) contain.emplace_back(graph[v], *wp);
+        std::sort(contain.begin(), contain.end());
+    };
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        mismatch += loaded[i] != g[indexes[i]] || loaded.find(g[indexes[i]]) != i;
+        adjacency(g, g.storage().forthRange(indexes[i]), expected);
+        adjacency(loaded, loaded.storage().forthRange(i), actual);
+        mismatch += expected != actual;
+        adjacency(g, g.storage().backRange(indexes[i]), expected);
+        adjacency(loaded, loaded.storage().backRange(i), actual);
+        mismatch += expected != actual;
+    }
+
+    std::string bytes;
+    {
+        std::ifstream reader(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>());
+    }
+    auto rejected = [&](const std::string& content) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(content.data(), content.size());
+        try {
+            LoadedGraph broken;
+            snapshot::load(broken, path);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    size_t rejects = 0, attempts = 0;
+    for (size_t length: {size_t(0), sizeof(snapshot::Header), bytes.size() / 2, bytes.size() - 64}) {
+        rejects += rejected(bytes.substr(0, length));
+        ++attempts;
+    }
+    // an offset entry that points past the target array
+    snapshot::Header h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    std::string corrupt = bytes;
+    uint64_t past = h.entry_count + 1;
+    std::memcpy(corrupt.data() + h.offsets_offset + sizeof(uint64_t), &past, sizeof(past));
+    rejects += rejected(corrupt);
+    ++attempts;
+    // another graph whose value section is cut short: its edges pass before the values fail,
+    // and loaded must keep the graph it already holds
+    NamedGraph other;
+    other.addNode("a");
+    other.addNode("b");
+    other.addEdge(0, 1, 1);
+    snapshot::save(other, path);
+    std::string cut;
+    {
+        std::ifstream reader(path, std::ios::binary);
+        cut.assign(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>());
+    }
+    snapshot::Header short_values;
+    std::memcpy(&short_values, cut.data(), sizeof(short_values));
+    short_values.values_length = 1;
+    std::memcpy(cut.data(), &short_values, sizeof(short_values));
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(cut.data(), cut.size());
+    try {
+        snapshot::load(loaded, path);
+    } catch (const std::runtime_error&) {
+        ++rejects;
+    }
+    ++attempts;
+    mismatch += loaded.countVertex() != indexes.size() || loaded.countEdge() != edges;
+    std::filesystem::remove(path);
+
+    std::cout << "Snapshot round trip, " << indexes.size() << " vertices, "
+        << edges << " edges, " << bytes.size() / 1024 << " KiB\n"
+        << "  save: " << save_ms << " ms, load: " << load_ms << " ms\n"
+        << "  mismatches: " << mismatch << '\n'
+        << "  corrupt files rejected: " << rejects << " of " << attempts << '\n';
+}
+
+typedef SimpleGraph<
+    size_t, int, true, size_t,
+    CsrStorage<size_t, int, true>
+> ScanGraph;
+
+// mean distance between the indexes of an edge's endpoints, a proxy for cache misses
+double meanEdgeGap(const ScanGraph& g) {
+    double total = 0;
+    size_t edges = 0;
+    for (auto u: g.allIndexes()) {
+        for (auto [v, wp]: g.storage().forthRange(u)) {
+            total += u > v ? u - v : v - u;
+            ++edges;
+        }
+    }
+    return edges == 0 ? 0 : total / edges;
+}
+
+// BFS and PageRank on an R-MAT graph with shuffled labels, before and after reordering
+void benchReorder(size_t scale, size_t threads) {
+    auto list = generators::RMat<size_t, int>(scale, 16, 20240527);
+    std::vector<size_t> label(list.vertex);
+    for (size_t i = 0; i < label.size(); ++i) label[i] = i;
+    std::shuffle(label.begin(), label.end(), std::mt19937_64(20240527));
+    ScanGraph shuffled;
+    for (size_t i = 0; i < list.vertex; ++i) shuffled.emplaceNode(i);
+    std::vector<ScanGraph::edge_type> edges;
+    edges.reserve(list.edges.size());
+    for (auto& [from, to, weight]: list.edges) edges.emplace_back(label[from], label[to], weight);
+    shuffled.bulkLoad(edges, threads);
+    size_t source = label[0];
+
+    std::cout << "Reorder R-MAT scale " << scale << ", " << list.edges.size() << " edges\n";
+    auto report = [&](const char* name, const ScanGraph& g, size_t from, size_t reorder_ms) {
+        size_t reached = 0;
+        size_t bfs_ms = timeMs([&] {
+            algorithms::BFS(g.const_access(from), [&](const size_t&) { ++reached; return true; });
+        });
+        size_t rank_ms = timeMs([&] { algorithms::PageRank(g, 0.85, 1e-9, 20, threads); });
+        std::cout << "  " << name << ": reorder " << reorder_ms << " ms, BFS " << bfs_ms
+            << " ms (" << reached << " reached), PageRank x20 " << rank_ms
+            << " ms, mean edge gap " << static_cast<size_t>(meanEdgeGap(g)) << '\n';
+    };
+    report("shuffled", shuffled, source, 0);
+
+    algorithms::Permutation<size_t> perm;
+    ScanGraph degree_sorted, rcm;
+    size_t degree_ms = timeMs([&] {
+        perm = algorithms::DegreeOrder(shuffled);
+        degree_sorted = algorithms::Reorder(shuffled, perm);
+    });
+    report("degree  ", degree_sorted, perm.new_index[source], degree_ms);
+    size_t rcm_ms = timeMs([&] {
+        perm = algorithms::ReverseCuthillMcKee(shuffled);
+        rcm = algorithms::Reorder(shuffled, perm);
+    });
+    report("RCM     ", rcm, perm.new_index[source], rcm_ms);
+
+    // out-edges only: a chain probed from its middle must still place every vertex
+    SimpleGraph<size_t, int, true> chain;
+    for (size_t i = 0; i < 64; ++i) chain.emplaceNode(i);
+    for (size_t i = 0; i + 1 < 64; ++i) chain.addEdge(i, i + 1, 1);
+    perm = algorithms::ReverseCuthillMcKee(chain);
+    std::cout << "  directed chain: " << perm.order.size() << " of "
+        << chain.countVertex() << " vertices ordered\n";
+}
+
+int main(int argc, char* argv[]) {
+    size_t vertex = 1024;
+    size_t threads = std::thread::hardware_concurrency();
+    size_t social = 200000;
+    if (argc > 1) vertex = std::stoul(argv[1]);
+    if (argc > 2) threads = std::stoul(argv[2]);
+    if (argc > 3) social = std::stoul(argv[3]);
+
+    benchFloyd(vertex, threads);
+    benchMatrixGrowth(vertex * 4);
+    benchPointToPoint(social, 100);
+    benchAStar(512, 20);
+    benchIngest(social, social * 8, threads);
+    benchConcurrentReads(social, threads);
+    benchConcurrentHub(1024, threads);
+    benchSnapshot(social);
+    benchKeyLookup(social * 5);
+    // smallest R-MAT scale with at least `social` vertices
+    benchReorder(std::max<size_t>(std::bit_width(social - 1), 1), threads);
+    return 0;
+}
@@ -3,6 +3,15 @@
 #define _DSL_GENERAL_HPP_ 1
 
 #include <limits>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
 
 namespace dsl {
 namespace general {
@@ -32,6 +41,130 @@ constexpr bool is_hashable_v = is_hashable<T>::value;
 
 #endif
 
+/**
+ * 固定大小的线程池
+ * run(count, fn) 将 fn(0) ... fn(count - 1) 分发到工作线程上执行，
+ * 调用线程同样参与执行，所有任务完成后返回。
+ * 同一时刻只允许一个线程调用 run。
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake, done;
+    const std::function<void(size_t)>* job;
+    size_t job_count, active;
+    std::atomic<size_t> next_task;
+    uint64_t generation;
+    bool stopping;
+
+    void drain() {
+        size_t task;
+        while ((task = next_task.fetch_add(1)) < job_count) (*job)(task);
+    }
+
+    void work() {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [this, &seen] {
+                    return stopping || generation != seen;
+                });
+                if (stopping) return ;
+                seen = generation;
+            }
+            drain();
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (--active == 0) done.notify_all();
+            }
+        }
+    }
+
+public:
+    /**
+     * @param thread_count 线程总数（含调用线程），0 表示使用硬件并发数
+     */
+    explicit ThreadPool(size_t thread_count = 0):
+        workers(), job(nullptr), job_count(0), active(0),
+        next_task(0), generation(0), stopping(false)
+    {
+        if (thread_count == 0) thread_count = std::thread::hardware_concurrency();
+        if (thread_count == 0) thread_count = 1;
+        workers.reserve(thread_count - 1);
+        for (size_t i = 1; i < thread_count; ++i) {
+            workers.emplace_back(&ThreadPool::work, this);
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker: workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size() + 1; }
+
+    void run(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) return ;
+        if (workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return ;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            job = &fn;
+            job_count = count;
+            next_task.store(0);
+            active = workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [this] { return active == 0; });
+        job = nullptr;
+    }
+};
+
+/**
+ * 并行稳定排序
+ * 各线程先对连续分块排序，再逐轮两两归并相邻分块。
+ */
+template<class _Iter, class _Comp>
+void parallel_sort(_Iter first, _Iter last, _Comp comp, ThreadPool& pool) {
+    size_t n = static_cast<size_t>(last - first);
+    // small inputs are not worth the hand-off
+    size_t chunks = std::min(pool.size(), n / 4096 + 1);
+    if (chunks <= 1) {
+        std::stable_sort(first, last, comp);
+        return ;
+    }
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) bounds[i] = n * i / chunks;
+    pool.run(chunks, [&](size_t c) {
+        std::stable_sort(first + bounds[c], first + bounds[c + 1], comp);
+    });
+    for (size_t width = 1; width < chunks; width <<= 1) {
+        size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        pool.run(pairs, [&](size_t p) {
+            size_t lo = p * 2 * width;
+            size_t mid = std::min(lo + width, chunks);
+            size_t hi = std::min(lo + 2 * width, chunks);
+            if (mid == hi) return ;
+            std::inplace_merge(
+                first + bounds[lo], first + bounds[mid], first + bounds[hi], comp
+            );
+        });
+    }
+}
+
 }
 // namespace dsl::utils
 
@@ -0,0 +1,159 @@
+#ifndef _DSL_GRAPH_GENERATORS_HPP_
+#define _DSL_GRAPH_GENERATORS_HPP_
+
+#include <vector>
+#include <tuple>
+#include <random>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+
+namespace dsl {
+namespace graph {
+namespace generators {
+
+/**
+ * 生成的边表，结点下标为 [0, vertex)
+ * edges 按 (from, to) 排序，不含自环与重边，可直接交给 bulkLoad。
+ */
+template<class _IdxTp, class _WhtTp>
+struct EdgeList {
+    typedef std::tuple<_IdxTp, _IdxTp, _WhtTp> edge_type;
+
+    size_t vertex = 0;
+    std::vector<edge_type> edges;
+};
+
+namespace detail {
+
+// uniform weights in [1, max_weight]; bool weights are always true
+template<class _WhtTp>
+struct weight_source {
+    std::conditional_t<
+        std::is_floating_point_v<_WhtTp>,
+        std::uniform_real_distribution<_WhtTp>,
+        std::uniform_int_distribution<long long>
+    > dist;
+
+    explicit weight_source(_WhtTp max_weight):
+        dist(1, std::is_same_v<_WhtTp, bool> ? 1 : max_weight) { }
+
+    template<class _Engine>
+    _WhtTp operator()(_Engine& engine) {
+        if constexpr (std::is_same_v<_WhtTp, bool>) return true;
+        else return static_cast<_WhtTp>(dist(engine));
+    }
+};
+
+template<class _IdxTp, class _WhtTp>
+void normalize(std::vector<std::tuple<_IdxTp, _IdxTp, _WhtTp>>& edges) {
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [](const auto& e) {
+        return std::get<0>(e) == std::get<1>(e);
+    }), edges.end());
+    std::sort(edges.begin(), edges.end(), [](const auto& l, const auto& r) {
+        return std::tie(std::get<0>(l), std::get<1>(l)) < std::tie(std::get<0>(r), std::get<1>(r));
+    });
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const auto& l, const auto& r) {
+        return std::get<0>(l) == std::get<0>(r) && std::get<1>(l) == std::get<1>(r);
+    }), edges.end());
+}
+
+}
+// namespace dsl::graph::generators::detail
+
+/**
+ * R-MAT（Kronecker）图，2^scale 个结点，抽样 edge_factor * 2^scale 条边
+ * 每条边逐位在四个象限中以概率 a, b, c, 1-a-b-c 递归选择，
+ * 得到幂律度分布与明显的社区结构；默认参数与 Graph500 相同。
+ * 去掉自环与重边后实际边数会少于抽样数。
+ */
+template<class _IdxTp = size_t, class _WhtTp = int>
+EdgeList<_IdxTp, _WhtTp> RMat(
+    size_t scale, size_t edge_factor, uint64_t seed,
+    _WhtTp max_weight = _WhtTp(100),
+    double a = 0.57, double b = 0.19, double c = 0.19
+) {
+    EdgeList<_IdxTp, _WhtTp> result;
+    result.vertex = size_t(1) << scale;
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    detail::weight_source<_WhtTp> weight(max_weight);
+    size_t samples = edge_factor << scale;
+    result.edges.reserve(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        size_t from = 0, to = 0;
+        for (size_t bit = 0; bit < scale; ++bit) {
+            double p = coin(engine);
+            from <<= 1;
+            to <<= 1;
+            if (p < a) continue;
+            if (p < a + b) to |= 1;
+            else if (p < a + b + c) from |= 1;
+            else { from |= 1; to |= 1; }
+        }
+        result.edges.emplace_back(
+            static_cast<_IdxTp>(from), static_cast<_IdxTp>(to), weight(engine)
+        );
+    }
+    detail::normalize(result.edges);
+    return result;
+}
+
+/**
+ * Erdős–Rényi G(n, m) 图，均匀抽样 edges 条有向边
+ */
+template<class _IdxTp = size_t, class _WhtTp = int>
+EdgeList<_IdxTp, _WhtTp> ErdosRenyi(
+    size_t vertex, size_t edges, uint64_t seed,
+    _WhtTp max_weight = _WhtTp(100)
+) {
+    EdgeList<_IdxTp, _WhtTp> result;
+    result.vertex = vertex;
+    if (vertex == 0) return result;
+    std::mt19937_64 engine(seed);
+    std::uniform_int_distribution<size_t> pick(0, vertex - 1);
+    detail::weight_source<_WhtTp> weight(max_weight);
+    result.edges.reserve(edges);
+    for (size_t i = 0; i < edges; ++i) {
+        result.edges.emplace_back(
+            static_cast<_IdxTp>(pick(engine)), static_cast<_IdxTp>(pick(engine)),
+            weight(engine)
+        );
+    }
+    detail::normalize(result.edges);
+    return result;
+}
+
+/**
+ * width x height 的四连通网格，结点 (x, y) 的下标为 y * width + x
+ * 每对相邻结点之间有两个方向的边，权值独立抽样。
+ */
+template<class _IdxTp = size_t, class _WhtTp = int>
+EdgeList<_IdxTp, _WhtTp> Grid2D(
+    size_t width, size_t height, uint64_t seed,
+    _WhtTp max_weight = _WhtTp(100)
+) {
+    EdgeList<_IdxTp, _WhtTp> result;
+    result.vertex = width * height;
+    std::mt19937_64 engine(seed);
+    detail::weight_source<_WhtTp> weight(max_weight);
+    result.edges.reserve(result.vertex * 4);
+    auto link = [&](size_t u, size_t v) {
+        result.edges.emplace_back(static_cast<_IdxTp>(u), static_cast<_IdxTp>(v), weight(engine));
+        result.edges.emplace_back(static_cast<_IdxTp>(v), static_cast<_IdxTp>(u), weight(engine));
+    };
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            size_t i = y * width + x;
+            if (x + 1 < width) link(i, i + 1);
+            if (y + 1 < height) link(i, i + width);
+        }
+    }
+    detail::normalize(result.edges);
+    return result;
+}
+
+}}}
+// namespace dsl::graph::generators
+
+#endif /* _DSL_GRAPH_GENERATORS_HPP_ */
@@ -14,6 +14,29 @@
 #include <queue>
 #include <stdint.h>
 #include <functional>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <bit>
+#include <atomic>
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <istream>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <cmath>
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #ifdef __cpp_concepts
 #include <concepts>
@@ -122,11 +145,13 @@ concept StorageProvider =
         { t.removeIndex(index) } -> std::same_as<typename T::index_type>;
         { t.addEdge(index, index, weight) } ;
         { t.removeEdge(index, index) } ;
-        { t.getWeight(index, index) } -> std::same_as<const typename T::weight_type&>;
+        { t.getWeight(index, index) } -> std::convertible_to<const typename T::weight_type&>;
         { t.setWeight(index, index, weight) } ;
         { t.expose() } -> std::same_as<typename T::storage_type*>;
         { t.getForth(index, contain) } ;
         { t.getBack(index, contain) } ;
+        { t.forthRange(index) } ;
+        { t.backRange(index) } ;
     }
 ;
 
@@ -196,6 +221,26 @@ struct index_limits {
     static constexpr T min() noexcept { return std::numeric_limits<T>::min(); }
 };
 
+/**
+ * SimpleGraph::bulkLoad 的统计信息
+ */
+struct IngestStats {
+    // edges given or parsed
+    size_t read = 0;
+    // edges handed to the storage provider after deduplication
+    size_t loaded = 0;
+    // malformed lines or unknown endpoints
+    size_t skipped = 0;
+    double parse_seconds = 0, sort_seconds = 0, build_seconds = 0;
+
+    double seconds() const { return parse_seconds + sort_seconds + build_seconds; }
+    // input edges per second
+    double throughput() const {
+        double total = seconds();
+        return total > 0 ? static_cast<double>(read) / total : 0;
+    }
+};
+
 
 /**
  * @brief 自定义类型的键选择器
@@ -220,6 +265,727 @@ struct key_selector {
     }
 };
 
+/**
+ * d 叉堆（小根），支持 decrease-key
+ * 键为稠密的整数下标，堆元素 (priority, key) 连续存放，
+ * pos 数组记录每个键在堆中的位置，按需增长。
+ * @tparam _Arity 分叉数，4 时子结点恰好落在同一缓存行附近
+ */
+template<size_t _Arity, class _KeyTp, class _PrioTp>
+class DaryHeap {
+    static_assert(_Arity >= 2, "DaryHeap: arity should be at least 2");
+public:
+    typedef _KeyTp key_type;
+    typedef _PrioTp priority_type;
+    typedef std::pair<priority_type, key_type> item_type;
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+    std::vector<item_type> heap;
+    std::vector<size_t> pos;
+
+    inline void place(size_t i, const item_type& item) {
+        heap[i] = item;
+        pos[static_cast<size_t>(item.second)] = i;
+    }
+
+    void sift_up(size_t i) {
+        item_type item = heap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / _Arity;
+            if (!(item.first < heap[parent].first)) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, item);
+    }
+
+    void sift_down(size_t i) {
+        item_type item = heap[i];
+        size_t n = heap.size();
+        while (true) {
+            size_t first = i * _Arity + 1;
+            if (first >= n) break;
+            size_t last = std::min(first + _Arity, n), best = first;
+            for (size_t c = first + 1; c < last; ++c) {
+                if (heap[c].first < heap[best].first) best = c;
+            }
+            if (!(heap[best].first < item.first)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, item);
+    }
+
+public:
+    DaryHeap(): heap(), pos() { }
+
+    void reserve(size_t key_count) {
+        heap.reserve(key_count);
+        if (pos.size() < key_count) pos.resize(key_count, npos);
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    bool contains(const key_type& key) const {
+        size_t k = static_cast<size_t>(key);
+        return k < pos.size() && pos[k] != npos;
+    }
+
+    const item_type& top() const { return heap.front(); }
+
+    /**
+     * 插入键（要求键当前不在堆中）
+     */
+    void push(const key_type& key, const priority_type& prio) {
+        size_t k = static_cast<size_t>(key);
+        if (k >= pos.size()) pos.resize(std::max(k + 1, pos.size() * 2), npos);
+        heap.emplace_back(prio, key);
+        sift_up(heap.size() - 1);
+    }
+
+    /**
+     * 降低键的优先级，新优先级不更小时不做任何事
+     */
+    void decrease(const key_type& key, const priority_type& prio) {
+        size_t i = pos[static_cast<size_t>(key)];
+        if (!(prio < heap[i].first)) return ;
+        heap[i].first = prio;
+        sift_up(i);
+    }
+
+    /**
+     * 键不在堆中时插入，否则尝试 decrease-key
+     */
+    void update(const key_type& key, const priority_type& prio) {
+        if (contains(key)) decrease(key, prio);
+        else push(key, prio);
+    }
+
+    item_type pop() {
+        item_type ret = heap.front();
+        pos[static_cast<size_t>(ret.second)] = npos;
+        if (heap.size() > 1) {
+            heap.front() = heap.back();
+            heap.pop_back();
+            sift_down(0);
+        } else {
+            heap.pop_back();
+        }
+        return ret;
+    }
+
+    void clear() {
+        for (auto& item: heap) pos[static_cast<size_t>(item.second)] = npos;
+        heap.clear();
+    }
+};
+
+/**
+ * 基数堆（单调小根堆），用于非负整数优先级
+ * 要求弹出的优先级单调不减；不支持 decrease-key，
+ * 使用方需自行跳过过期的元素。
+ */
+template<class _KeyTp>
+class RadixHeap {
+public:
+    typedef _KeyTp key_type;
+    typedef uint64_t priority_type;
+    typedef std::pair<priority_type, key_type> item_type;
+
+private:
+    static constexpr size_t bucket_count = 65;
+
+    std::vector<item_type> buckets[bucket_count];
+    priority_type last;
+    size_t count;
+
+    static inline size_t bucket_of(priority_type prio, priority_type last) {
+        return prio == last ? 0 : 64 - std::countl_zero(prio ^ last);
+    }
+
+public:
+    RadixHeap(): last(0), count(0) { }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    /**
+     * 插入元素，要求 prio 不小于最近一次弹出的优先级
+     */
+    void push(const key_type& key, priority_type prio) {
+        buckets[bucket_of(prio, last)].emplace_back(prio, key);
+        ++count;
+    }
+
+    item_type pop() {
+        if (buckets[0].empty()) {
+            size_t i = 1;
+            while (buckets[i].empty()) ++i;
+            auto& src = buckets[i];
+            last = std::min_element(src.cbegin(), src.cend())->first;
+            for (auto& item: src) {
+                buckets[bucket_of(item.first, last)].push_back(item);
+            }
+            src.clear();
+        }
+        item_type ret = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return ret;
+    }
+
+    void clear() {
+        for (auto& bucket: buckets) bucket.clear();
+        last = 0;
+        count = 0;
+    }
+};
+
+/**
+ * 并查集（按秩合并 + 路径减半），find / unite 均摊 O(α(n))
+ * 元素为稠密的整数下标，按需增长；未加入的下标不属于任何集合。
+ */
+template<class _IdxTp>
+class DisjointSet {
+public:
+    typedef _IdxTp index_type;
+    static constexpr index_type nindex = index_limits<index_type>::max();
+
+private:
+    std::vector<index_type> parent;
+    std::vector<uint8_t> rank;
+    size_t sets;
+
+public:
+    DisjointSet(): parent(), rank(), sets(0) { }
+
+    /**
+     * 加入单元素集合，已存在时忽略
+     */
+    void add(index_type v) {
+        size_t i = static_cast<size_t>(v);
+        if (i >= parent.size()) {
+            parent.resize(std::max(i + 1, parent.size() * 2), nindex);
+            rank.resize(parent.size(), 0);
+        }
+        if (parent[i] != nindex) return ;
+        parent[i] = v;
+        rank[i] = 0;
+        ++sets;
+    }
+
+    bool contains(index_type v) const {
+        size_t i = static_cast<size_t>(v);
+        return i < parent.size() && parent[i] != nindex;
+    }
+
+    /**
+     * 所在集合的代表元，未加入时返回 nindex
+     */
+    index_type find(index_type v) {
+        if (!contains(v)) return nindex;
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+    /**
+     * 合并两个集合，发生合并时返回 true
+     */
+    bool unite(index_type a, index_type b) {
+        a = find(a);
+        b = find(b);
+        if (a == nindex || b == nindex || a == b) return false;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) ++rank[a];
+        --sets;
+        return true;
+    }
+
+    bool connected(index_type a, index_type b) {
+        index_type ra = find(a);
+        return ra != nindex && ra == find(b);
+    }
+
+    // number of disjoint sets
+    size_t count() const { return sets; }
+
+    void clear() {
+        parent.clear();
+        rank.clear();
+        sets = 0;
+    }
+};
+
+/**
+ * 字符串键的驻留表，键到下标的映射
+ * 键的字节只复制一次，存放在分块的内存池中，表项保存指向池中的视图、
+ * 缓存的 64 位哈希值与下标。查找使用线性探测的开放寻址表，
+ * 槽中带有哈希的高 32 位，绝大多数不相等的键在比较字符串前即被排除。
+ * freeze() 为当前的键集构造完美哈希（hash-and-displace），冻结后的查找只访问一个位置；
+ * 冻结后任何插入或删除都会先解冻。删除的键所占的池空间在 clear() 前不回收。
+ * 最多容纳 2^32 - 1 个键。
+ */
+template<class _IdxTp>
+class KeyTable {
+public:
+    typedef _IdxTp index_type;
+    static constexpr index_type npos = index_limits<index_type>::max();
+
+private:
+    typedef KeyTable<_IdxTp> self;
+
+    struct entry {
+        std::string_view key;
+        uint64_t hash;
+        index_type index;
+    };
+
+    static constexpr size_t chunk_size = 64 * 1024;
+    static constexpr uint64_t low_mask = 0xffffffffull;
+    // displacements tried per bucket before freeze() gives up
+    static constexpr uint32_t max_displace = 1u << 16;
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* cursor;
+    size_t left;
+    size_t pooled;
+    std::vector<entry> entries;
+    // high 32 bits of the hash | entry + 1, 0 for an empty slot
+    std::vector<uint64_t> slots;
+    // frozen mode: displacement per bucket, entry + 1 per place
+    std::vector<uint32_t> displace;
+    std::vector<uint32_t> places;
+    bool is_frozen;
+
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+    static uint64_t hash_of(std::string_view key) {
+        return mix(std::hash<std::string_view>{}(key));
+    }
+    // map the high 32 bits onto [0, n)
+    static size_t reduce(uint64_t h, size_t n) {
+        return static_cast<size_t>(((h >> 32) * n) >> 32);
+    }
+    size_t bucket_of(uint64_t h) const { return reduce(h, displace.size()); }
+    size_t place_of(uint64_t h, uint32_t d) const {
+        return reduce(mix(h ^ (d * 0x9e3779b97f4a7c15ull)), places.size());
+    }
+
+    std::string_view store(std::string_view key) {
+        if (key.empty()) return std::string_view();
+        pooled += key.size();
+        // long keys get a block of their own and keep the current chunk
+        if (key.size() > chunk_size / 4) {
+            chunks.emplace_back(new char[key.size()]);
+            std::memcpy(chunks.back().get(), key.data(), key.size());
+            return std::string_view(chunks.back().get(), key.size());
+        }
+        if (left < key.size()) {
+            chunks.emplace_back(new char[chunk_size]);
+            cursor = chunks.back().get();
+            left = chunk_size;
+        }
+        std::memcpy(cursor, key.data(), key.size());
+        std::string_view result(cursor, key.size());
+        cursor += key.size();
+        left -= key.size();
+        return result;
+    }
+
+    void place(size_t e) {
+        size_t mask = slots.size() - 1;
+        uint64_t h = entries[e].hash;
+        size_t i = h & mask;
+        while (slots[i] != 0) i = (i + 1) & mask;
+        slots[i] = (h & ~low_mask) | (e + 1);
+    }
+
+    void rehash(size_t capacity) {
+        slots.assign(std::max<size_t>(std::bit_ceil(capacity), 16), 0);
+        for (size_t e = 0; e < entries.size(); ++e) place(e);
+    }
+
+    // slot holding the key, slots.size() when absent
+    size_t slot_of(std::string_view key, uint64_t h) const {
+        if (slots.empty()) return slots.size();
+        size_t mask = slots.size() - 1;
+        uint64_t tag = h & ~low_mask;
+        for (size_t i = h & mask; slots[i] != 0; i = (i + 1) & mask) {
+            if ((slots[i] & ~low_mask) != tag) continue;
+            if (entries[(slots[i] & low_mask) - 1].key == key) return i;
+        }
+        return slots.size();
+    }
+
+    // entry of the key, entries.size() when absent
+    size_t entry_of(std::string_view key) const {
+        uint64_t h = hash_of(key);
+        if (is_frozen) {
+            if (places.empty()) return entries.size();
+            uint32_t e = places[place_of(h, displace[bucket_of(h)])];
+            if (e != 0 && entries[e - 1].hash == h && entries[e - 1].key == key) return e - 1;
+            return entries.size();
+        }
+        size_t i = slot_of(key, h);
+        return i < slots.size() ? (slots[i] & low_mask) - 1 : entries.size();
+    }
+
+    // backward-shift deletion keeps probe sequences free of tombstones
+    void vacate(size_t hole) {
+        size_t mask = slots.size() - 1;
+        for (size_t j = (hole + 1) & mask; slots[j] != 0; j = (j + 1) & mask) {
+            size_t home = entries[(slots[j] & low_mask) - 1].hash & mask;
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+        }
+        slots[hole] = 0;
+    }
+
+    void copy_from(const self& kt) {
+        clear();
+        entries.reserve(kt.entries.size());
+        for (auto& e: kt.entries) entries.push_back({store(e.key), e.hash, e.index});
+        slots = kt.slots;
+        displace = kt.displace;
+        places = kt.places;
+        is_frozen = kt.is_frozen;
+    }
+    void move_from(self& kt) {
+        chunks = std::move(kt.chunks);
+        cursor = kt.cursor;
+        left = kt.left;
+        pooled = kt.pooled;
+        entries = std::move(kt.entries);
+        slots = std::move(kt.slots);
+        displace = std::move(kt.displace);
+        places = std::move(kt.places);
+        is_frozen = kt.is_frozen;
+        kt.clear();
+    }
+
+public:
+    KeyTable():
+        chunks(), cursor(nullptr), left(0), pooled(0),
+        entries(), slots(), displace(), places(), is_frozen(false)
+    { }
+
+    KeyTable(const self& kt): KeyTable() { copy_from(kt); }
+    KeyTable(self&& kt): KeyTable() { move_from(kt); }
+    self& operator= (const self& kt) { if (this != &kt) copy_from(kt); return *this; }
+    self& operator= (self&& kt) { if (this != &kt) move_from(kt); return *this; }
+
+    size_t size() const { return entries.size(); }
+    bool frozen() const { return is_frozen; }
+    // key bytes copied into the pool, removed keys included
+    size_t pooledBytes() const { return pooled; }
+
+    /**
+     * 键对应的下标，不存在时返回 npos
+     */
+    index_type find(std::string_view key) const {
+        size_t e = entry_of(key);
+        return e < entries.size() ? entries[e].index : npos;
+    }
+
+    /**
+     * 加入键，键已存在时保留原有的下标并返回 false
+     */
+    bool insert(std::string_view key, index_type index) {
+        if (is_frozen) thaw();
+        uint64_t h = hash_of(key);
+        if (slot_of(key, h) < slots.size()) return false;
+        if (entries.size() >= low_mask) return false;
+        if ((entries.size() + 1) * 4 > slots.size() * 3) rehash(slots.size() * 2);
+        entries.push_back({store(key), h, index});
+        place(entries.size() - 1);
+        return true;
+    }
+
+    /**
+     * 删除键，仅当其下标为 index 时生效
+     */
+    void erase(std::string_view key, index_type index) {
+        if (is_frozen) thaw();
+        size_t i = slot_of(key, hash_of(key));
+        if (i >= slots.size()) return ;
+        size_t e = (slots[i] & low_mask) - 1;
+        if (entries[e].index != index) return ;
+        vacate(i);
+        size_t last = entries.size() - 1;
+        if (e != last) {
+            // the last entry moves into the gap, repoint its slot
+            size_t mask = slots.size() - 1;
+            size_t j = entries[last].hash & mask;
+            while ((slots[j] & low_mask) != last + 1) j = (j + 1) & mask;
+            slots[j] = (slots[j] & ~low_mask) | (e + 1);
+            entries[e] = entries[last];
+        }
+        entries.pop_back();
+    }
+
+    /**
+     * 将键的下标由 from 改为 to，不改变冻结状态
+     */
+    void reassign(std::string_view key, index_type from, index_type to) {
+        size_t e = entry_of(key);
+        if (e < entries.size() && entries[e].index == from) entries[e].index = to;
+    }
+
+    /**
+     * 为当前的键集构造完美哈希并释放开放寻址表
+     * 键被分入约 n / 4 个桶，从大到小依次为每个桶寻找一个位移，
+     * 使桶内的键落在 1.25n 个位置中互不冲突的空位上。
+     * 失败时（如两个键的 64 位哈希相同）保持原状并返回 false。
+     */
+    bool freeze() {
+        if (is_frozen) return true;
+        size_t n = entries.size();
+        std::vector<uint32_t> new_displace(std::max<size_t>(n / 4, 1), 0);
+        std::vector<uint32_t> new_places(n + n / 4 + 1, 0);
+        displace.swap(new_displace);
+        places.swap(new_places);
+
+        // counting sort of the entries by bucket
+        std::vector<uint32_t> offsets(displace.size() + 1, 0), order(n);
+        for (auto& e: entries) ++offsets[bucket_of(e.hash) + 1];
+        for (size_t b = 0; b < displace.size(); ++b) offsets[b + 1] += offsets[b];
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t e = 0; e < n; ++e) order[fill[bucket_of(entries[e].hash)]++] = e;
+        }
+        std::vector<uint32_t> buckets(displace.size());
+        for (size_t b = 0; b < buckets.size(); ++b) buckets[b] = b;
+        std::sort(buckets.begin(), buckets.end(), [&offsets](uint32_t l, uint32_t r) {
+            return offsets[l + 1] - offsets[l] > offsets[r + 1] - offsets[r];
+        });
+
+        std::vector<size_t> trial;
+        bool ok = true;
+        for (uint32_t b: buckets) {
+            if (offsets[b] == offsets[b + 1]) break;
+            uint32_t d = 0;
+            for (; d < max_displace; ++d) {
+                trial.clear();
+                for (size_t k = offsets[b]; k < offsets[b + 1]; ++k) {
+                    size_t p = place_of(entries[order[k]].hash, d);
+                    if (places[p] != 0 || std::find(trial.begin(), trial.end(), p) != trial.end()) break;
+                    trial.push_back(p);
+                }
+                if (trial.size() == offsets[b + 1] - offsets[b]) break;
+            }
+            if (d == max_displace) { ok = false; break; }
+            displace[b] = d;
+            for (size_t k = 0; k < trial.size(); ++k) places[trial[k]] = order[offsets[b] + k] + 1;
+        }
+        if (!ok) {
+            displace.clear();
+            places.clear();
+            return false;
+        }
+        is_frozen = true;
+        slots.clear();
+        slots.shrink_to_fit();
+        return true;
+    }
+
+    /**
+     * 丢弃完美哈希，重建开放寻址表
+     */
+    void thaw() {
+        if (!is_frozen) return ;
+        is_frozen = false;
+        displace.clear();
+        displace.shrink_to_fit();
+        places.clear();
+        places.shrink_to_fit();
+        rehash(entries.size() * 4 / 3 + 1);
+    }
+
+    void clear() {
+        chunks.clear();
+        cursor = nullptr;
+        left = 0;
+        pooled = 0;
+        entries.clear();
+        slots.clear();
+        displace.clear();
+        places.clear();
+        is_frozen = false;
+    }
+};
+
+/**
+ * 分片的读写锁，每个分片独占一条缓存行
+ * 读者只锁住键所在的分片，不同分片上的读者互不争用同一缓存行；
+ * 需要独占整个结构时按分片顺序锁住全部分片。
+ * 同时锁多个分片时一律按分片号升序加锁，以免死锁。
+ */
+template<size_t _Shards>
+class ShardedMutex {
+    static_assert(_Shards > 0, "ShardedMutex: shard count should be positive");
+
+    struct alignas(64) slot {
+        std::shared_mutex mutex;
+    };
+    std::array<slot, _Shards> slots;
+
+public:
+    static constexpr size_t shards = _Shards;
+
+    ShardedMutex(): slots() { }
+
+    static size_t shardOf(size_t key) { return key % _Shards; }
+
+    /**
+     * 当前线程固定使用的分片，各线程轮流分配
+     */
+    static size_t threadShard() {
+        static std::atomic<size_t> next{0};
+        thread_local size_t mine = next.fetch_add(1, std::memory_order_relaxed) % _Shards;
+        return mine;
+    }
+
+    std::shared_mutex& shard(size_t s) { return slots[s].mutex; }
+
+    // a failed lock releases the shards already taken before rethrowing
+    void lockAll() {
+        size_t taken = 0;
+        try {
+            for (; taken < _Shards; ++taken) slots[taken].mutex.lock();
+        } catch (...) {
+            while (taken > 0) slots[--taken].mutex.unlock();
+            throw;
+        }
+    }
+    void unlockAll() { for (auto& s: slots) s.mutex.unlock(); }
+    void lockAllShared() {
+        size_t taken = 0;
+        try {
+            for (; taken < _Shards; ++taken) slots[taken].mutex.lock_shared();
+        } catch (...) {
+            while (taken > 0) slots[--taken].mutex.unlock_shared();
+            throw;
+        }
+    }
+    void unlockAllShared() { for (auto& s: slots) s.mutex.unlock_shared(); }
+
+    /**
+     * 独占两个键所在的分片（可以相同）
+     */
+    void lockPair(size_t a, size_t b) {
+        size_t lo = std::min(shardOf(a), shardOf(b)), hi = std::max(shardOf(a), shardOf(b));
+        slots[lo].mutex.lock();
+        if (hi == lo) return ;
+        try {
+            slots[hi].mutex.lock();
+        } catch (...) {
+            slots[lo].mutex.unlock();
+            throw;
+        }
+    }
+    void unlockPair(size_t a, size_t b) {
+        size_t lo = std::min(shardOf(a), shardOf(b)), hi = std::max(shardOf(a), shardOf(b));
+        if (hi != lo) slots[hi].mutex.unlock();
+        slots[lo].mutex.unlock();
+    }
+
+    // scoped holders of lockAll / lockAllShared / lockPair
+    struct all_guard {
+        ShardedMutex& m;
+        explicit all_guard(ShardedMutex& mutex): m(mutex) { m.lockAll(); }
+        ~all_guard() { m.unlockAll(); }
+        all_guard(const all_guard&) = delete;
+        all_guard& operator=(const all_guard&) = delete;
+    };
+    struct shared_all_guard {
+        ShardedMutex& m;
+        explicit shared_all_guard(ShardedMutex& mutex): m(mutex) { m.lockAllShared(); }
+        ~shared_all_guard() { m.unlockAllShared(); }
+        shared_all_guard(const shared_all_guard&) = delete;
+        shared_all_guard& operator=(const shared_all_guard&) = delete;
+    };
+    struct pair_guard {
+        ShardedMutex& m;
+        size_t a, b;
+        pair_guard(ShardedMutex& mutex, size_t x, size_t y): m(mutex), a(x), b(y) { m.lockPair(a, b); }
+        ~pair_guard() { m.unlockPair(a, b); }
+        pair_guard(const pair_guard&) = delete;
+        pair_guard& operator=(const pair_guard&) = delete;
+    };
+};
+
+/**
+ * 邻接点的惰性区间，遍历时不分配内存
+ * 元素为 std::pair<index_type, weight_type*>
+ * _Cursor 需提供以下成员：
+ * -# typedef index_type / weight_type
+ * -# bool done() const
+ * -# void next()
+ * -# index_type index() const
+ * -# weight_type* weight() const
+ */
+template<class _Cursor>
+class AdjacentRange {
+public:
+    typedef typename _Cursor::index_type index_type;
+    typedef typename _Cursor::weight_type weight_type;
+    typedef std::pair<index_type, weight_type*> value_type;
+
+    struct sentinel { };
+
+    class iterator {
+    private:
+        _Cursor cursor;
+    public:
+        typedef AdjacentRange::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+
+        iterator(): cursor() { }
+        explicit iterator(const _Cursor& c): cursor(c) { }
+
+        value_type operator*() const {
+            return value_type(cursor.index(), cursor.weight());
+        }
+        iterator& operator++() { cursor.next(); return *this; }
+        iterator operator++(int) { iterator ret = *this; cursor.next(); return ret; }
+
+        bool operator==(const sentinel&) const { return cursor.done(); }
+        bool operator!=(const sentinel&) const { return !cursor.done(); }
+    };
+
+private:
+    _Cursor first;
+
+public:
+    explicit AdjacentRange(const _Cursor& c): first(c) { }
+
+    iterator begin() const { return iterator(first); }
+    sentinel end() const { return sentinel(); }
+    bool empty() const { return first.done(); }
+
+    // O(deg), walks the whole range
+    size_t count() const {
+        size_t ret = 0;
+        for (_Cursor c = first; !c.done(); c.next()) ++ret;
+        return ret;
+    }
+};
+
 }
 // namespace dsl::graph::utils
 
@@ -254,6 +1020,62 @@ struct AdjPreview {
     ): index(idx), value_ptr(vp), weight_ptr(wp) { }
 };
 
+/**
+ * 访问器使用的惰性邻接视图
+ * 包装存储提供的邻接区间，解引用时才构造 AdjPreview，
+ * 遍历过程中不分配内存。
+ * 结构化绑定元素顺序与 AdjPreview 相同。
+ */
+template<
+    class _Range,
+    class _cvIdxProv,
+    class _Preview
+>
+class AdjacentView {
+public:
+    typedef _Preview value_type;
+    typedef typename _Range::sentinel sentinel;
+
+    class iterator {
+    private:
+        typename _Range::iterator iter;
+        _cvIdxProv* index_ptr;
+    public:
+        iterator(
+            const typename _Range::iterator& it,
+            _cvIdxProv* ip
+        ): iter(it), index_ptr(ip) { }
+
+        value_type operator*() const {
+            auto [idx, wp] = *iter;
+            return value_type(idx, &(index_ptr->at(idx)), wp);
+        }
+        iterator& operator++() { ++iter; return *this; }
+
+        bool operator==(const sentinel& s) const { return iter == s; }
+        bool operator!=(const sentinel& s) const { return iter != s; }
+    };
+
+private:
+    _Range range;
+    _cvIdxProv* index_ptr;
+
+public:
+    AdjacentView(
+        const _Range& r,
+        _cvIdxProv* ip
+    ): range(r), index_ptr(ip) { }
+
+    iterator begin() const { return iterator(range.begin(), index_ptr); }
+    sentinel end() const { return range.end(); }
+    bool empty() const { return range.empty(); }
+
+    /**
+     * 只遍历下标与权值，不访问结点值
+     */
+    _Range raw() const { return range; }
+};
+
 /**
  * SimpleGraph类使用的访问器（非const）
  * 提供对于访问器所指结点的值的引用访问，
@@ -358,6 +1180,12 @@ public:
      */
     index_type raw() const { return index; }
 
+    /**
+     * 访问器所在图的存储与下标提供器
+     */
+    _cvStProv& storage() const { return *storage_ptr; }
+    _cvIdxProv& indexProvider() const { return *index_ptr; }
+
     /**
      * 将通过下标移动访问器至指定点
      * （不做连通性检查）
@@ -414,10 +1242,33 @@ public:
      3. weight_type*
     */
     const adjacent_list& listBack() const { return back_list; }
-};
-
-}
-// namespace dsl::graph::accessor
+
+    /**
+     由出边连接的邻接点的惰性视图，直接遍历存储中的邻接结构，
+     无需先调用 updateAdjacent，也不产生中间列表。
+     存储结构改变后视图失效。
+     结构化绑定元素顺序与 listForth 相同。
+    */
+    auto forth() const {
+        auto range = storage_ptr->forthRange(index);
+        return AdjacentView<
+            decltype(range), _cvIdxProv, preview_type
+        >(range, index_ptr);
+    }
+
+    /**
+     由入边连接的邻接点的惰性视图，见 forth()
+    */
+    auto back() const {
+        auto range = storage_ptr->backRange(index);
+        return AdjacentView<
+            decltype(range), _cvIdxProv, preview_type
+        >(range, index_ptr);
+    }
+};
+
+}
+// namespace dsl::graph::accessor
 
 template<
     DSL_MACRO_VALUE_TYPE _ValTp,
@@ -471,6 +1322,33 @@ public:
         }
     }
 
+    // the reverse map is owned, copies get their own
+    DefaultIndexProvider(const DefaultIndexProvider& ip):
+    present_index(ip.present_index), st(ip.st), rst_ptr(nullptr) {
+        if constexpr (enable_rhb) rst_ptr = new reverse_map_t(*ip.rst_ptr);
+    }
+    DefaultIndexProvider(DefaultIndexProvider&& ip):
+    present_index(ip.present_index), st(std::move(ip.st)), rst_ptr(ip.rst_ptr) {
+        if constexpr (enable_rhb) ip.rst_ptr = new reverse_map_t();
+    }
+    DefaultIndexProvider& operator= (const DefaultIndexProvider& ip) {
+        if (this == &ip) return *this;
+        present_index = ip.present_index;
+        st = ip.st;
+        if constexpr (enable_rhb) *rst_ptr = *ip.rst_ptr;
+        return *this;
+    }
+    DefaultIndexProvider& operator= (DefaultIndexProvider&& ip) {
+        if (this == &ip) return *this;
+        present_index = ip.present_index;
+        st = std::move(ip.st);
+        if constexpr (enable_rhb) {
+            rst_ptr->clear();
+            std::swap(rst_ptr, ip.rst_ptr);
+        }
+        return *this;
+    }
+
     void allIndexes(std::vector<index_type>& contain) const {
         for (auto& pair: st) contain.emplace_back(pair.first);
     }
@@ -519,7 +1397,8 @@ public:
     std::vector<index_type> findAll(const key_type& key) const {
         std::vector<index_type> results;
         if constexpr (enable_rhb) {
-            results.emplace_back(rst_ptr->at(key));
+            auto iter = rst_ptr->find(key);
+            if (iter != rst_ptr->cend()) results.emplace_back(iter->second);
         } else {
             for (
                 auto iter = st.cbegin();
@@ -536,7 +1415,8 @@ public:
 
     index_type find(const key_type& key) const {
         if constexpr (enable_rhb) {
-            return rst_ptr->at(key);
+            auto iter = rst_ptr->find(key);
+            return iter == rst_ptr->cend() ? limit::max() : iter->second;
         } else {
             for (auto iter = st.cbegin(); iter != st.cend(); ++iter) {
                 if (select_key::key(iter->second) == key) return iter->first;
@@ -558,50 +1438,454 @@ public:
 
 };
 
+/**
+ * 稠密下标提供器
+ * 结点值存放在连续的槽数组中，at(index) 为一次数组访问；
+ * 删除的槽在墓碑位图中标记并进入空闲链表，之后插入的结点优先复用。
+ * 删除最后一个槽时直接收缩数组，配合 MatrixStorage 时矩阵保持紧凑。
+ * 槽数组扩容后先前取得的结点值指针失效。
+ */
+template<
+    DSL_MACRO_VALUE_TYPE _ValTp,
+    DSL_MACRO_DEFAULT_INDEX _IdxTp,
+    bool _EnableReverseHashBoost = true
+>
+class DenseIndexProvider {
+public:
+    typedef _ValTp value_type;
+    typedef _IdxTp index_type;
+    typedef utils::key_selector<value_type>::key_type key_type;
+private:
+    typedef utils::key_selector<value_type> select_key;
+    typedef utils::index_limits<_IdxTp> limit;
+    static constexpr bool enable_rhb = (
+        general::utils::is_hashable_v<key_type> &&
+        _EnableReverseHashBoost
+    );
+    // unhashable keys get an empty placeholder, std::hash<key_type> is never named
+    typedef std::conditional_t<
+        enable_rhb,
+        std::unordered_map<key_type, index_type>,
+        std::tuple<>
+    > reverse_map_t;
+
+    std::vector<value_type> slots;
+    std::vector<uint64_t> dead;
+    std::vector<index_type> free_list;
+    reverse_map_t rst;
+    size_t alive_count;
+
+    inline bool is_dead(size_t i) const {
+        return (dead[i >> 6] >> (i & 63)) & 1;
+    }
+    inline void mark(size_t i, bool is_dead) {
+        if (is_dead) dead[i >> 6] |= uint64_t(1) << (i & 63);
+        else dead[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+
+    // slot for a new value, reusing the free list first
+    size_t acquire() {
+        if (!free_list.empty()) {
+            size_t i = static_cast<size_t>(free_list.back());
+            free_list.pop_back();
+            mark(i, false);
+            return i;
+        }
+        size_t i = slots.size();
+        slots.emplace_back();
+        if (dead.size() * 64 < slots.size()) dead.push_back(0);
+        return i;
+    }
+
+    void forget_key(size_t i) {
+        if constexpr (enable_rhb) {
+            auto iter = rst.find(select_key::key(slots[i]));
+            if (iter != rst.end() && static_cast<size_t>(iter->second) == i) {
+                rst.erase(iter);
+            }
+        }
+    }
+
+    // tombstone slot i, or drop it when it is the last one
+    void release(size_t i) {
+        slots[i] = value_type();
+        --alive_count;
+        if (i + 1 == slots.size()) {
+            slots.pop_back();
+            mark(i, false);
+            if (dead.size() * 64 >= slots.size() + 64) dead.pop_back();
+        } else {
+            mark(i, true);
+            free_list.push_back(static_cast<index_type>(i));
+        }
+    }
+
+public:
+#ifdef DSL_DEBUG
+
+    void _show() const {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (is_dead(i)) std::cout << i << "=>(dead)\n";
+            else std::cout << i << "=>" << &slots[i] << '\n';
+        }
+        std::cout << "Total: " << alive_count
+            << "\tFree: " << free_list.size() << '\n';
+    }
+
+#endif
+
+    DenseIndexProvider():
+        slots(), dead(), free_list(), rst(), alive_count(0)
+    { }
+
+    void allIndexes(std::vector<index_type>& contain) const {
+        contain.reserve(contain.size() + alive_count);
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (!is_dead(i)) contain.emplace_back(static_cast<index_type>(i));
+        }
+    }
+
+    index_type insert(const value_type& node) {
+        size_t i = acquire();
+        slots[i] = node;
+        ++alive_count;
+        if constexpr (enable_rhb) {
+            rst.emplace(select_key::key(slots[i]), static_cast<index_type>(i));
+        }
+        return static_cast<index_type>(i);
+    }
+    template<class... Args>
+    index_type emplace(Args&&... args) {
+        size_t i = acquire();
+        slots[i] = value_type(std::forward<Args>(args)...);
+        ++alive_count;
+        if constexpr (enable_rhb) {
+            rst.emplace(select_key::key(slots[i]), static_cast<index_type>(i));
+        }
+        return static_cast<index_type>(i);
+    }
+
+    void remove(index_type index) {
+        size_t i = static_cast<size_t>(index);
+        if (i >= slots.size() || is_dead(i)) return ;
+        forget_key(i);
+        release(i);
+    }
+
+    /**
+     * 将 from 处的结点移动到 to 处并释放 from 的槽，
+     * 供交换删除的存储（如 MatrixStorage）保持下标与键的对应关系
+     */
+    void relocate(index_type from, index_type to) {
+        size_t f = static_cast<size_t>(from), t = static_cast<size_t>(to);
+        if (f == t) return remove(from);
+        forget_key(t);
+        slots[t] = std::move(slots[f]);
+        if constexpr (enable_rhb) {
+            auto iter = rst.find(select_key::key(slots[t]));
+            if (iter != rst.end() && static_cast<size_t>(iter->second) == f) {
+                iter->second = to;
+            }
+        }
+        release(f);
+    }
+
+    size_t size() const { return alive_count; }
+
+    /**
+     * 下标的上界，所有有效下标均小于该值
+     */
+    size_t bound() const { return slots.size(); }
+
+    bool alive(index_type index) const {
+        size_t i = static_cast<size_t>(index);
+        return i < slots.size() && !is_dead(i);
+    }
+
+    std::vector<index_type> findAll(const key_type& key) const {
+        std::vector<index_type> results;
+        if constexpr (enable_rhb) {
+            auto iter = rst.find(key);
+            if (iter != rst.cend()) results.emplace_back(iter->second);
+        } else {
+            for (size_t i = 0; i < slots.size(); ++i) {
+                if (!is_dead(i) && select_key::key(slots[i]) == key) {
+                    results.emplace_back(static_cast<index_type>(i));
+                }
+            }
+        }
+        return results;
+    }
+
+    index_type find(const key_type& key) const {
+        if constexpr (enable_rhb) {
+            auto iter = rst.find(key);
+            return iter == rst.cend() ? limit::max() : iter->second;
+        } else {
+            for (size_t i = 0; i < slots.size(); ++i) {
+                if (!is_dead(i) && select_key::key(slots[i]) == key) {
+                    return static_cast<index_type>(i);
+                }
+            }
+            return limit::max();
+        }
+    }
+
+    const value_type& at(index_type index) const { return slots[index]; }
+    value_type& at(index_type index) { return slots[index]; }
+
+    index_type available() const {
+        for (size_t w = 0; w < dead.size(); ++w) {
+            uint64_t live = ~dead[w];
+            if (live == 0) continue;
+            size_t i = w * 64 + std::countr_zero(live);
+            if (i < slots.size()) return static_cast<index_type>(i);
+            break;
+        }
+        return limit::max();
+    }
+
+    /**
+     * 使下一次插入使用给定的下标（该下标需已被释放）
+     */
+    void rewind(index_type index) {
+        auto iter = std::find(free_list.rbegin(), free_list.rend(), index);
+        if (iter == free_list.rend()) return ;
+        std::iter_swap(iter, free_list.rbegin());
+    }
+
+};
+
+/**
+ * 字符串键驻留的下标提供器
+ * 结点值存放在 DenseIndexProvider 的槽数组中，键到下标的映射由 utils::KeyTable 维护，
+ * 键的字节只复制一次，查找时先比较缓存的哈希值再比较字符串。
+ * 批量加载结束后调用 freeze() 切换到完美哈希，之后增删结点会自动解冻。
+ * 键类型需能转换为 std::string_view；find 在键不存在时返回下标的最大值。
+ */
+template<
+    DSL_MACRO_VALUE_TYPE _ValTp,
+    DSL_MACRO_DEFAULT_INDEX _IdxTp
+>
+class InternedIndexProvider {
+public:
+    typedef _ValTp value_type;
+    typedef _IdxTp index_type;
+    typedef utils::key_selector<value_type>::key_type key_type;
+
+    static_assert(
+        std::is_convertible_v<const key_type&, std::string_view>,
+        "InternedIndexProvider: key type should convert to std::string_view"
+    );
+
+private:
+    typedef utils::key_selector<value_type> select_key;
+    typedef utils::index_limits<_IdxTp> limit;
+
+    DenseIndexProvider<value_type, index_type, false> slots;
+    utils::KeyTable<index_type> keys;
+
+    std::string_view key_of(index_type index) const {
+        return std::string_view(select_key::key(slots.at(index)));
+    }
+
+public:
+#ifdef DSL_DEBUG
+
+    void _show() const {
+        slots._show();
+        std::cout << "Keys: " << keys.size() << "\tPooled: " << keys.pooledBytes()
+            << (keys.frozen() ? "\tfrozen\n" : "\n");
+    }
+
+#endif
+
+    InternedIndexProvider(): slots(), keys() { }
+
+    void allIndexes(std::vector<index_type>& contain) const { slots.allIndexes(contain); }
+
+    index_type insert(const value_type& node) {
+        index_type idx = slots.insert(node);
+        keys.insert(key_of(idx), idx);
+        return idx;
+    }
+    template<class... Args>
+    index_type emplace(Args&&... args) {
+        index_type idx = slots.emplace(std::forward<Args>(args)...);
+        keys.insert(key_of(idx), idx);
+        return idx;
+    }
+
+    void remove(index_type index) {
+        if (!slots.alive(index)) return ;
+        keys.erase(key_of(index), index);
+        slots.remove(index);
+    }
+
+    /**
+     * [DenseIndexProvider.relocate]
+     */
+    void relocate(index_type from, index_type to) {
+        if (from == to) return remove(from);
+        if (slots.alive(to)) keys.erase(key_of(to), to);
+        keys.reassign(key_of(from), from, to);
+        slots.relocate(from, to);
+    }
+
+    size_t size() const { return slots.size(); }
+    size_t bound() const { return slots.bound(); }
+    bool alive(index_type index) const { return slots.alive(index); }
+
+    std::vector<index_type> findAll(const key_type& key) const {
+        std::vector<index_type> results;
+        index_type idx = find(key);
+        if (idx != limit::max()) results.emplace_back(idx);
+        return results;
+    }
+
+    index_type find(const key_type& key) const { return keys.find(std::string_view(key)); }
+
+    const value_type& at(index_type index) const { return slots.at(index); }
+    value_type& at(index_type index) { return slots.at(index); }
+
+    index_type available() const { return slots.available(); }
+    void rewind(index_type index) { slots.rewind(index); }
+
+    /**
+     * [KeyTable.freeze]
+     */
+    bool freeze() { return keys.freeze(); }
+    bool frozen() const { return keys.frozen(); }
+    const utils::KeyTable<index_type>& keyTable() const { return keys; }
+
+};
+
+/**
+ * 基于哈希表的邻接表存储
+ * @tparam _EnableBackIndex 是否为有向图维护入边索引。
+ * 开启后 getBack 与 removeIndex 的代价与结点的度成正比，
+ * 代价是每条边额外占用一个入边表项；无向图不需要入边索引。
+ * @tparam _Arena 邻接表及其结点是否从存储自有的内存池中分配。
+ * 开启后各邻接表为 std::pmr 容器，共用一个 unsynchronized_pool_resource，
+ * 建图时的分配从池中成块取得，不再每条边调用一次 operator new；
+ * 删除的边与扩容前的桶数组回到池中复用。析构或复制覆盖时整个池一次释放，
+ * 键与权值可平凡析构时不再逐条销毁邻接表中的边。
+ * 池不加锁，与存储本身一样不能被多个写者同时使用（ConcurrentStorage 会串行化写者）。
+ */
 template<
     DSL_MACRO_HASH_INDEX _IdxTp,
     DSL_MACRO_WEIGHT_TYPE _WhtTp,
-    bool _Directed
+    bool _Directed,
+    bool _EnableBackIndex = false,
+    bool _Arena = false
 >
 class HashListStorage {
 public:
     typedef _IdxTp index_type;
     typedef _WhtTp weight_type;
-    typedef std::unordered_map<
-        index_type, std::unordered_map<index_type, weight_type>*
-    > storage_type;
+    // out-edges of a vertex: target => weight
+    typedef std::conditional_t<
+        _Arena,
+        std::pmr::unordered_map<index_type, weight_type>,
+        std::unordered_map<index_type, weight_type>
+    > adjacent_type;
+    typedef std::unordered_map<index_type, adjacent_type*> storage_type;
+    typedef std::tuple<index_type, index_type, weight_type> edge_type;
     typedef utils::null_weight<weight_type> null_weight;
 
     static constexpr weight_type fallback = null_weight::value();
 
 private:
-    typedef HashListStorage<_IdxTp, _WhtTp, _Directed> self;
+    typedef HashListStorage<_IdxTp, _WhtTp, _Directed, _EnableBackIndex, _Arena> self;
     typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
     typedef utils::index_limits<index_type> idx_limit;
+    // in-edges of a vertex: source => weight stored in the source's out map
+    typedef std::conditional_t<
+        _Arena,
+        std::pmr::unordered_map<index_type, weight_type*>,
+        std::unordered_map<index_type, weight_type*>
+    > back_adjacent_type;
+    typedef std::unordered_map<index_type, back_adjacent_type*> back_storage_type;
+    static constexpr bool enable_bi = _Directed && _EnableBackIndex;
+    // pooled maps whose destructors only hand memory back to the pool
+    static constexpr bool trivial_release = (
+        _Arena &&
+        std::is_trivially_destructible_v<index_type> &&
+        std::is_trivially_destructible_v<weight_type>
+    );
+    typedef std::conditional_t<
+        _Arena, std::unique_ptr<std::pmr::unsynchronized_pool_resource>, char
+    > pool_type;
 
+    pool_type pool;
     storage_type list;
+    back_storage_type back_list;
     size_t edge_count;
 
+    template<class _MapTp, class... Args>
+    _MapTp* make_map(Args&&... args) {
+        if constexpr (_Arena) {
+            if (!pool) pool = std::make_unique<std::pmr::unsynchronized_pool_resource>();
+            return std::pmr::polymorphic_allocator<>(pool.get()).new_object<_MapTp>(
+                std::forward<Args>(args)...
+            );
+        } else {
+            return new _MapTp(std::forward<Args>(args)...);
+        }
+    }
+    template<class _MapTp>
+    void drop_map(_MapTp* map_ptr) {
+        if constexpr (_Arena) {
+            std::pmr::polymorphic_allocator<>(pool.get()).delete_object(map_ptr);
+        } else {
+            delete map_ptr;
+        }
+    }
+
     void clear_up() {
-        for (auto& pair: list) delete pair.second;
+        if constexpr (!trivial_release) {
+            for (auto& pair: list) drop_map(pair.second);
+            if constexpr (enable_bi) {
+                for (auto& pair: back_list) drop_map(pair.second);
+            }
+        }
+        list.clear();
+        back_list.clear();
+        // every pooled map goes at once
+        if constexpr (_Arena) pool.reset();
         edge_count = 0;
     }
+    void rebuild_back() {
+        for (auto [index, st_ptr]: list) {
+            back_list.emplace(index, make_map<back_adjacent_type>());
+        }
+        for (auto [index, st_ptr]: list) {
+            for (auto& [to, weight]: *st_ptr) {
+                back_list[to]->emplace(index, &weight);
+            }
+        }
+    }
     void copy_from(const self& h) {
         clear_up();
         for(auto [index, st_ptr]: h.list) {
-            list.emplace(
-                index,
-                new std::unordered_map<index_type, weight_type>(*st_ptr)
-            );
+            list.emplace(index, make_map<adjacent_type>(*st_ptr));
         }
+        // back pointers have to point into the copied maps
+        if constexpr (enable_bi) rebuild_back();
         edge_count = h.edge_count;
     }
     void move_from(self& rh) {
         clear_up();
+        // the maps live in the pool, so it moves with them
+        if constexpr (_Arena) pool = std::move(rh.pool);
         for (auto [index, st_ptr]: rh.list) {
             list.emplace(index, st_ptr);
         }
         rh.list.clear();
+        if constexpr (enable_bi) {
+            back_list = std::move(rh.back_list);
+            rh.back_list.clear();
+        }
         edge_count = rh.edge_count;
     }
 
@@ -621,13 +1905,13 @@ public:
 
 #endif
 
-    HashListStorage(): list(), edge_count(0) {  }
+    HashListStorage(): pool(), list(), back_list(), edge_count(0) {  }
     ~HashListStorage() { clear_up(); }
     
-    HashListStorage(const self& h) { copy_from(h); }
-    HashListStorage(self&& h) { move_from(h); }
-    self& operator= (const self& h) { copy_from(h); return *this; }
-    self& operator= (self&& h) { move_from(h); return *this; }
+    HashListStorage(const self& h): HashListStorage() { copy_from(h); }
+    HashListStorage(self&& h): HashListStorage() { move_from(h); }
+    self& operator= (const self& h) { if (this != &h) copy_from(h); return *this; }
+    self& operator= (self&& h) { if (this != &h) move_from(h); return *this; }
 
     /**
      * [StorageProvider.expose]
@@ -645,28 +1929,46 @@ public:
     void addIndex(const index_type& idx) {
         auto iter = list.find(idx);
         if (iter != list.end()) return ;
-        list.emplace(
-            idx,
-            new std::unordered_map<index_type, weight_type>()
-        );
+        list.emplace(idx, make_map<adjacent_type>());
+        if constexpr (enable_bi) {
+            back_list.emplace(idx, make_map<back_adjacent_type>());
+        }
     }
 
     /**
+     * O(deg) for undirected graphs or with the back index enabled,
+     * otherwise every adjacency map is scanned.
      * [StorageProvider.removeIndex]
      */
     index_type removeIndex(const index_type& idx) {
         size_t rm_edge = 0;
         auto iter = list.find(idx);
         if (iter == list.end()) return idx_limit::max();
-        rm_edge += iter->second->size();
-        list.erase(iter);
-        for (auto [index, st_ptr]: list) {
-            if constexpr (_Directed) {
-                rm_edge += st_ptr->erase(idx);
-            } else {
-                st_ptr->erase(idx);
+        auto adj_ptr = iter->second;
+        rm_edge += adj_ptr->size();
+        if constexpr (!_Directed) {
+            for (auto& pair: *adj_ptr) {
+                if (pair.first != idx) list[pair.first]->erase(idx);
+            }
+        } else if constexpr (enable_bi) {
+            for (auto& pair: *adj_ptr) {
+                if (pair.first != idx) back_list[pair.first]->erase(idx);
+            }
+            auto back_iter = back_list.find(idx);
+            for (auto& pair: *(back_iter->second)) {
+                if (pair.first == idx) continue;
+                list[pair.first]->erase(idx);
+                ++rm_edge;
+            }
+            drop_map(back_iter->second);
+            back_list.erase(back_iter);
+        } else {
+            for (auto [index, st_ptr]: list) {
+                if (index != idx) rm_edge += st_ptr->erase(idx);
             }
         }
+        drop_map(adj_ptr);
+        list.erase(iter);
         edge_count -= rm_edge;
         return idx_limit::max();
     }
@@ -688,11 +1990,14 @@ public:
         auto adj_ptr = iter_from->second;
         auto iter_to = adj_ptr->find(to);
         if (iter_to == adj_ptr->end()) {
-            adj_ptr->emplace(to, weight);
+            auto inserted = adj_ptr->emplace(to, weight).first;
+            if constexpr (enable_bi) {
+                back_list[to]->emplace(from, &(inserted->second));
+            }
+            ++edge_count;
         } else {
             iter_to->second = weight;
         }
-        ++edge_count;
         
         if constexpr (!_Directed) {
             auto adj_ptr = iter2_to->second;
@@ -705,6 +2010,50 @@ public:
         }
     }
 
+    /**
+     * 批量加入边，edges 须按 (from, to) 排序且无重复，无向边只给出一次。
+     * 先按度数预留各邻接表的容量再逐行插入，每行只查找一次起点。
+     * 端点不存在的边被忽略。
+     */
+    void bulkLoad(const std::vector<edge_type>& edges) {
+        std::unordered_map<index_type, size_t> degree;
+        for (auto& [from, to, weight]: edges) {
+            ++degree[from];
+            if constexpr (!_Directed) ++degree[to];
+        }
+        for (auto [index, count]: degree) {
+            auto iter = list.find(index);
+            if (iter != list.end()) {
+                iter->second->reserve(iter->second->size() + count);
+            }
+        }
+
+        size_t i = 0;
+        while (i < edges.size()) {
+            const index_type& from = std::get<0>(edges[i]);
+            size_t end = i;
+            while (end < edges.size() && std::get<0>(edges[end]) == from) ++end;
+            auto iter_from = list.find(from);
+            if (iter_from == list.end()) { i = end; continue; }
+            auto adj_ptr = iter_from->second;
+            for (; i < end; ++i) {
+                auto& [_, to, weight] = edges[i];
+                auto iter2_to = list.find(to);
+                if (iter2_to == list.end()) continue;
+                auto [inserted, fresh] = adj_ptr->insert_or_assign(to, weight);
+                if (fresh) {
+                    if constexpr (enable_bi) {
+                        back_list[to]->emplace(from, &(inserted->second));
+                    }
+                    ++edge_count;
+                }
+                if constexpr (!_Directed) {
+                    iter2_to->second->insert_or_assign(from, weight);
+                }
+            }
+        }
+    }
+
     /**
      * [StorageProvider.removeEdge]
      */
@@ -714,7 +2063,13 @@ public:
     ) {
         auto iter_from = list.find(from);
         if (iter_from == list.end()) return ;
-        iter_from->second->erase(to);
+        if (iter_from->second->erase(to) == 0) return ;
+        if constexpr (enable_bi) {
+            back_list[to]->erase(from);
+        }
+        if constexpr (!_Directed) {
+            list[to]->erase(from);
+        }
         --edge_count;
     }
 
@@ -754,6 +2109,7 @@ public:
             if (iter2 == iter->second->end()) {
                 return ;
             } else {
+                // the back index points at this slot, nothing else to update
                 iter2->second = weight;
             }
         }
@@ -782,12 +2138,24 @@ public:
     }
 
     /**
+     * O(deg) for undirected graphs or with the back index enabled.
      * [StorageProvider.getBack]
      */
     void getBack(
         const index_type& idx,
         contain_type& contain
     ) const {
+        if constexpr (!_Directed) {
+            getForth(idx, contain);
+            return ;
+        } else if constexpr (enable_bi) {
+            auto iter = back_list.find(idx);
+            if (iter == back_list.cend()) return ;
+            for (auto& pair: *(iter->second)) {
+                contain.emplace_back(pair.first, pair.second);
+            }
+            return ;
+        }
         for (auto [index, st_ptr]: list) {
             auto iter = st_ptr->find(idx);
             if (iter == st_ptr->cend()) continue;
@@ -797,21 +2165,234 @@ public:
             );
         }
     }
-};
-
-template<
-    DSL_MACRO_MATRIX_INDEX _IdxTp,
-    DSL_MACRO_WEIGHT_TYPE _WhtTp,
-    bool _Directed
->
-class MatrixStorage {
-public:
-    typedef _IdxTp index_type;
-    typedef _WhtTp weight_type;
-    typedef std::vector<std::vector<weight_type>*> storage_type;
-    typedef utils::null_weight<weight_type> null_weight;
-
-    static constexpr weight_type fallback = null_weight::value();
+
+    // cursor over a single adjacency map (out-edges or the back index)
+    template<class _MapTp>
+    struct map_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        typename _MapTp::iterator iter, end;
+
+        bool done() const { return iter == end; }
+        void next() { ++iter; }
+        index_type index() const { return iter->first; }
+        weight_type* weight() const {
+            if constexpr (std::is_pointer_v<typename _MapTp::mapped_type>) {
+                return iter->second;
+            } else {
+                return &(iter->second);
+            }
+        }
+    };
+    typedef map_cursor<adjacent_type> forth_cursor;
+
+    // in-edges without back index: probe every adjacency map
+    struct scan_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        typename storage_type::const_iterator iter, end;
+        index_type target;
+        weight_type* found;
+
+        void seek() {
+            for (; iter != end; ++iter) {
+                auto hit = iter->second->find(target);
+                if (hit != iter->second->end()) {
+                    found = &(hit->second);
+                    return ;
+                }
+            }
+        }
+        bool done() const { return iter == end; }
+        void next() { ++iter; seek(); }
+        index_type index() const { return iter->first; }
+        weight_type* weight() const { return found; }
+    };
+
+    /**
+     * 出边的惰性区间
+     */
+    utils::AdjacentRange<forth_cursor> forthRange(const index_type& idx) const {
+        forth_cursor cursor{};
+        auto iter = list.find(idx);
+        if (iter != list.cend()) {
+            cursor.iter = iter->second->begin();
+            cursor.end = iter->second->end();
+        }
+        return utils::AdjacentRange<forth_cursor>(cursor);
+    }
+
+    /**
+     * 入边的惰性区间
+     * 未开启入边索引的有向图需要扫描所有结点
+     */
+    auto backRange(const index_type& idx) const {
+        if constexpr (!_Directed) {
+            return forthRange(idx);
+        } else if constexpr (enable_bi) {
+            typedef map_cursor<back_adjacent_type> back_cursor;
+            back_cursor cursor{};
+            auto iter = back_list.find(idx);
+            if (iter != back_list.cend()) {
+                cursor.iter = iter->second->begin();
+                cursor.end = iter->second->end();
+            }
+            return utils::AdjacentRange<back_cursor>(cursor);
+        } else {
+            scan_cursor cursor{list.cbegin(), list.cend(), idx, nullptr};
+            cursor.seek();
+            return utils::AdjacentRange<scan_cursor>(cursor);
+        }
+    }
+};
+
+namespace utils {
+
+/**
+ * 存储的 backRange 是否需要扫描全部结点
+ * 依赖入边的算法（如自底向上的 BFS）据此决定是否使用入边
+ */
+template<class _StProv>
+struct scans_back_range: std::false_type { };
+
+template<class _IdxTp, class _WhtTp, bool _Arena>
+struct scans_back_range<
+    HashListStorage<_IdxTp, _WhtTp, true, false, _Arena>
+>: std::true_type { };
+
+/**
+ * 存储的 addEdge / removeEdge / setWeight 是否只改动两个端点各自的邻接结构
+ * （以及只在写者之间共享的计数），ConcurrentStorage 据此只锁端点所在的分片；
+ * 否则写边时独占整个存储。
+ * 写者之间本就串行，开启 _Arena 的 HashListStorage 共用的内存池也只被一个写者使用。
+ */
+template<class _StProv>
+struct shard_local_edges: std::false_type { };
+
+template<class _IdxTp, class _WhtTp, bool _Directed, bool _EnableBackIndex, bool _Arena>
+struct shard_local_edges<
+    HashListStorage<_IdxTp, _WhtTp, _Directed, _EnableBackIndex, _Arena>
+>: std::true_type { };
+
+/**
+ * 存储的 getBack 是否只读取该结点自身的邻接结构
+ * 否则 ConcurrentStorage 读入边时需要锁住全部分片。
+ */
+template<class _StProv>
+struct local_back_range: std::false_type { };
+
+template<class _IdxTp, class _WhtTp, bool _EnableBackIndex, bool _Arena>
+struct local_back_range<
+    HashListStorage<_IdxTp, _WhtTp, false, _EnableBackIndex, _Arena>
+>: std::true_type { };
+
+template<class _IdxTp, class _WhtTp, bool _Arena>
+struct local_back_range<
+    HashListStorage<_IdxTp, _WhtTp, true, true, _Arena>
+>: std::true_type { };
+
+/**
+ * 存储的 getWeight 的返回类型
+ * 通常为 const weight_type&；在锁外无法保证引用有效的存储（如 ConcurrentStorage）按值返回。
+ * 转发 getWeight 的包装器应使用该类型，以免返回临时对象的引用。
+ */
+template<class _StProv>
+using weight_result_t = decltype(std::declval<const _StProv&>().getWeight(
+    std::declval<const typename _StProv::index_type&>(),
+    std::declval<const typename _StProv::index_type&>()
+));
+
+/**
+ * 存储提供器的能力，由其是否提供相应成员在编译期推断，
+ * 算法据此选择专门的实现：
+ * -# contiguous：forthSpan(idx) / forthWeights(idx) 给出连续存放的出边终点与权重；
+ *    若另有 spansReady()，仅在其返回 true 时可用（如冻结后的 CsrStorage）；
+ * -# bit_rows：rowWords(idx) 给出按位存放的出边行，第 v 位对应终点 v；
+ * -# dense：下标为整数，可以直接用下标索引数组与位图；
+ * -# back_scan：见 scans_back_range。
+ */
+template<class _StProv>
+struct storage_traits {
+    typedef typename _StProv::index_type index_type;
+    typedef typename _StProv::weight_type weight_type;
+
+    static constexpr bool contiguous = requires(const _StProv& s, const index_type& i) {
+        s.forthSpan(i);
+        s.forthWeights(i);
+    };
+    static constexpr bool bit_rows = requires(const _StProv& s, const index_type& i) {
+        s.rowWords(i);
+    };
+    static constexpr bool dense = std::is_integral_v<index_type>;
+    static constexpr bool back_scan = scans_back_range<_StProv>::value;
+
+    static bool spansReady(const _StProv& s) {
+        if constexpr (!contiguous) return false;
+        else if constexpr (requires { s.spansReady(); }) return s.spansReady();
+        else return true;
+    }
+};
+
+/**
+ * 访问标记集合
+ * 整数下标使用按需增长的位图，其余下标使用哈希集合。
+ */
+template<class _IdxTp, bool _Dense = std::is_integral_v<_IdxTp>>
+class VisitSet {
+    std::unordered_set<_IdxTp> seen;
+public:
+    /**
+     * 标记 idx，此前未被标记时返回 true
+     */
+    bool insert(const _IdxTp& idx) { return seen.insert(idx).second; }
+    bool contains(const _IdxTp& idx) const { return seen.count(idx) != 0; }
+    void clear() { seen.clear(); }
+};
+
+template<class _IdxTp>
+class VisitSet<_IdxTp, true> {
+    std::vector<uint64_t> bits;
+public:
+    bool insert(const _IdxTp& idx) {
+        size_t i = static_cast<size_t>(idx), w = i >> 6;
+        if (w >= bits.size()) bits.resize(std::max(w + 1, bits.size() * 2), 0);
+        uint64_t mask = uint64_t(1) << (i & 63);
+        if (bits[w] & mask) return false;
+        bits[w] |= mask;
+        return true;
+    }
+    bool contains(const _IdxTp& idx) const {
+        size_t i = static_cast<size_t>(idx);
+        return (i >> 6) < bits.size() && ((bits[i >> 6] >> (i & 63)) & 1);
+    }
+    void clear() { std::fill(bits.begin(), bits.end(), 0); }
+
+    /**
+     * 至少包含 count 个字的位图，用于按字批量标记
+     */
+    uint64_t* words(size_t count) {
+        if (bits.size() < count) bits.resize(count, 0);
+        return bits.data();
+    }
+};
+
+}
+// namespace dsl::graph::utils
+
+template<
+    DSL_MACRO_MATRIX_INDEX _IdxTp,
+    DSL_MACRO_WEIGHT_TYPE _WhtTp,
+    bool _Directed
+>
+class MatrixStorage {
+public:
+    typedef _IdxTp index_type;
+    typedef _WhtTp weight_type;
+    typedef std::vector<std::vector<weight_type>*> storage_type;
+    typedef std::tuple<index_type, index_type, weight_type> edge_type;
+    typedef utils::null_weight<weight_type> null_weight;
+
+    static constexpr weight_type fallback = null_weight::value();
 
 private:
     typedef MatrixStorage<_IdxTp, _WhtTp, _Directed> self;
@@ -935,6 +2516,20 @@ public:
         ++edge_count;
     }
 
+    /**
+     * Writes a sorted, duplicate-free edge list row by row.
+     * Out-of-range edges are ignored.
+     */
+    void bulkLoad(const std::vector<edge_type>& edges) {
+        for (auto& [from, to, weight]: edges) {
+            if (from >= vex_size || to >= vex_size) continue;
+            weight_type& cell = (*matrix[from])[to];
+            if (cell == null_weight::value()) ++edge_count;
+            cell = weight;
+            if constexpr (!_Directed) (*matrix[to])[from] = weight;
+        }
+    }
+
     /**
      * Remove an edge from graph
      * [StorageProvider.removeEdge]
@@ -1068,362 +2663,4594 @@ public:
         return last;
     }
 
+    // cursor over one row (out-edges) or one column (in-edges)
+    struct line_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        const storage_type* matrix;
+        size_t fixed, pos, end;
+        bool column;
+
+        weight_type& cell(size_t i) const {
+            return column ? (*(*matrix)[i])[fixed] : (*(*matrix)[fixed])[i];
+        }
+        void seek() {
+            while (pos < end && cell(pos) == null_weight::value()) ++pos;
+        }
+        bool done() const { return pos >= end; }
+        void next() { ++pos; seek(); }
+        index_type index() const { return static_cast<index_type>(pos); }
+        weight_type* weight() const { return &cell(pos); }
+    };
+
+    /**
+     * 出边的惰性区间
+     */
+    utils::AdjacentRange<line_cursor> forthRange(index_type idx) const {
+        line_cursor cursor{&matrix, static_cast<size_t>(idx), 0, 0, false};
+        if (idx < vex_size) cursor.end = vex_size;
+        cursor.seek();
+        return utils::AdjacentRange<line_cursor>(cursor);
+    }
+
+    /**
+     * 入边的惰性区间
+     */
+    utils::AdjacentRange<line_cursor> backRange(index_type idx) const {
+        line_cursor cursor{&matrix, static_cast<size_t>(idx), 0, 0, true};
+        if (idx < vex_size) cursor.end = vex_size;
+        cursor.seek();
+        return utils::AdjacentRange<line_cursor>(cursor);
+    }
+
 };
 
-/*!
- * @brief 
- * @tparam _ValTp 
- * @tparam _WhtTp 
- * @tparam _Directed 
- * @tparam _IdxTp 
- * @tparam _StProv 
- * @tparam _IdxProv 
+/**
+ * 单块连续内存的邻接矩阵存储
+ * 容量 cap 按几何级数增长，第 v 行位于 [v * cap, v * cap + cap)，
+ * 增加结点的均摊代价为 O(V)，按行扫描为线性访存，复制只需一次分配。
+ * 删除结点的方式与 MatrixStorage 相同（末尾结点移入被删除的位置）。
  */
 template<
-    DSL_MACRO_VALUE_TYPE _ValTp,
+    DSL_MACRO_MATRIX_INDEX _IdxTp,
     DSL_MACRO_WEIGHT_TYPE _WhtTp,
-    bool _Directed,
-    DSL_MACRO_INDEX_TYPE _IdxTp = size_t,
-    DSL_MACRO_STORE_PROVIDER _StProv = HashListStorage<_IdxTp, _WhtTp, _Directed>,
-    DSL_MACRO_INDEX_PROVIDER _IdxProv = DefaultIndexProvider<_ValTp, _IdxTp>
+    bool _Directed
 >
-class SimpleGraph {
+class FlatMatrixStorage {
 public:
-    typedef _ValTp value_type;
     typedef _IdxTp index_type;
     typedef _WhtTp weight_type;
+    // expose() points at cell (0, 0), row v starts at v * capacity()
+    typedef weight_type storage_type;
+    typedef std::tuple<index_type, index_type, weight_type> edge_type;
     typedef utils::null_weight<weight_type> null_weight;
-    typedef utils::index_limits<index_type> idx_limit;
-    typedef _IdxProv::key_type key_type;
 
-    static constexpr index_type nindex = idx_limit::max();
-    static constexpr weight_type nweight = _StProv::fallback;
+    static constexpr weight_type fallback = null_weight::value();
 
 private:
-    typedef _IdxProv index_prov_t;
-    typedef _StProv store_prov_t;
-    typedef
-    SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>
-    self;
+    typedef FlatMatrixStorage<_IdxTp, _WhtTp, _Directed> self;
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef utils::index_limits<index_type> idx_limit;
 
-#ifdef DSL_DEBUG
-public:
-#else
-private:
-#endif
-    index_prov_t index_provider;
-    store_prov_t storage_provider;
+    std::unique_ptr<weight_type[]> cells;
+    size_t vex_size, cap, edge_count;
 
-private:
-    void copy_from(const self& g) {
-        index_provider = g.index_provider;
-        storage_provider = g.storage_provider;
+    weight_type& cell(size_t from, size_t to) const { return cells[from * cap + to]; }
+
+    void reallocate(size_t next) {
+        std::unique_ptr<weight_type[]> grown(new weight_type[next * next]);
+        std::fill_n(grown.get(), next * next, null_weight::value());
+        for (size_t i = 0; i < vex_size; ++i) {
+            std::copy_n(cells.get() + i * cap, vex_size, grown.get() + i * next);
+        }
+        cells.swap(grown);
+        cap = next;
     }
-    void move_from(self& g) {
-        index_provider = std::move(g.index_provider);
-        storage_provider = std::move(g.storage_provider);
+
+    void copy_from(const self& fms) {
+        if (this == &fms) return ;
+        cells.reset();
+        if (fms.cap != 0) {
+            cells.reset(new weight_type[fms.cap * fms.cap]);
+            std::copy_n(fms.cells.get(), fms.cap * fms.cap, cells.get());
+        }
+        vex_size = fms.vex_size;
+        cap = fms.cap;
+        edge_count = fms.edge_count;
+    }
+    void move_from(self& fms) {
+        cells = std::move(fms.cells);
+        vex_size = fms.vex_size;
+        cap = fms.cap;
+        edge_count = fms.edge_count;
+        fms.vex_size = fms.cap = fms.edge_count = 0;
     }
 
 public:
-    typedef accessors::GraphAccessor<
-        value_type, index_type, weight_type,
-        index_prov_t, store_prov_t
-    > accessor;
+#ifdef DSL_DEBUG
 
-    typedef accessors::GraphAccessor<
-        const value_type, index_type, weight_type,
-        const index_prov_t, const store_prov_t
-    > const_accessor;
+    void _show() const {
+        std::cout << "Flat Matrix:\n";
+        for (size_t i = 0; i < vex_size; ++i) {
+            for (size_t j = 0; j < vex_size; ++j) std::cout << cell(i, j) << ' ';
+            std::cout << '\n';
+        }
+        std::cout << "Vex Size: " << vex_size
+            << "\tCapacity: " << cap
+            << "\tEdge Count: " << edge_count << '\n';
+    }
 
-    SimpleGraph(){  };
-    SimpleGraph(const self& g) { copy_from(g); }
-    SimpleGraph(self&& rg) { move_from(rg); }
-    self& operator= (const self& g) { copy_from(g); return *this; }
-    self& operator= (self&& rg) { move_from(rg); return *this; }
+#endif
 
-    std::vector<index_type> findIndexes(
-        const key_type& key, size_t count = 1
-    ) const {
-        return index_provider.findAll(key);
+    FlatMatrixStorage(): cells(), vex_size(0), cap(0), edge_count(0) { }
+
+    FlatMatrixStorage(const self& fms): FlatMatrixStorage() { copy_from(fms); }
+    FlatMatrixStorage(self&& fms): FlatMatrixStorage() { move_from(fms); }
+    self& operator=(const self& fms) { copy_from(fms); return *this; }
+    self& operator=(self&& fms) { move_from(fms); return *this; }
+
+    size_t size() const { return edge_count; }
+    size_t capacity() const { return cap; }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return cells.get(); }
+
+    /**
+     * Grows capacity geometrically, squeezing clears cells beyond v_size.
+     * [StorageProvider.sync]
+     */
+    void sync(size_t v_size) {
+        if (v_size >= vex_size) {
+            if (v_size > cap) reallocate(std::max(v_size, cap * 2));
+            vex_size = v_size;
+            return ;
+        }
+        for (size_t i = 0; i < vex_size; ++i) {
+            size_t from = i < v_size ? v_size : 0;
+            std::fill(
+                cells.get() + i * cap + from,
+                cells.get() + i * cap + vex_size,
+                null_weight::value()
+            );
+        }
+        vex_size = v_size;
     }
 
-    index_type find(
-        const key_type& key
-    ) const {
-        return index_provider.find(key);
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(index_type) { }
+
+    /**
+     * Moves the last vertex into idx like MatrixStorage.
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(index_type idx) {
+        if (static_cast<size_t>(idx) >= vex_size) return idx_limit::max();
+        size_t v = static_cast<size_t>(idx), last = vex_size - 1;
+        size_t rm_edges = 0;
+        for (size_t i = 0; i < vex_size; ++i) {
+            if (cell(v, i) != null_weight::value()) ++rm_edges;
+            if constexpr (_Directed) {
+                if (i != v && cell(i, v) != null_weight::value()) ++rm_edges;
+            }
+        }
+        edge_count -= rm_edges;
+
+        if (v != last) {
+            std::copy_n(cells.get() + last * cap, vex_size, cells.get() + v * cap);
+            // after the row copy, (v, v) picks up the old (last, last)
+            for (size_t i = 0; i < vex_size; ++i) cell(i, v) = cell(i, last);
+        }
+        for (size_t i = 0; i < vex_size; ++i) {
+            cell(last, i) = null_weight::value();
+            cell(i, last) = null_weight::value();
+        }
+        return static_cast<index_type>(last);
     }
 
-    std::vector<index_type> allIndexes() const {
-        std::vector<index_type> result;
-        index_provider.allIndexes(result);
-        return result;
+    /**
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(index_type from, index_type to, const weight_type& weight) {
+        if (from >= vex_size || to >= vex_size) return ;
+        // a null weight is an empty cell, so writing one removes the edge
+        if (weight == null_weight::value()) return removeEdge(from, to);
+        weight_type& target = cell(from, to);
+        if (target == null_weight::value()) ++edge_count;
+        target = weight;
+        if constexpr (!_Directed) cell(to, from) = weight;
     }
 
-    const value_type& nodeAt(const index_type& index) const {
-        return index_provider.at(index);
+    /**
+     * Writes a sorted, duplicate-free edge list. Out-of-range edges are ignored.
+     */
+    void bulkLoad(const std::vector<edge_type>& edges) {
+        for (auto& [from, to, weight]: edges) addEdge(from, to, weight);
     }
-    value_type& nodeAt(const index_type& index) {
-        return index_provider.at(index);
+
+    /**
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(index_type from, index_type to) {
+        if (from >= vex_size || to >= vex_size) return ;
+        if (cell(from, to) == null_weight::value()) return ;
+        cell(from, to) = null_weight::value();
+        if constexpr (!_Directed) cell(to, from) = null_weight::value();
+        --edge_count;
     }
 
-    index_type addNode(const value_type& val) {
-        storage_provider.sync(index_provider.size() + 1);
-        index_type idx = index_provider.insert(val);
-        storage_provider.addIndex(idx);
-        return idx;
+    /**
+     * [StorageProvider.getWeight]
+     */
+    const weight_type& getWeight(index_type from, index_type to) const {
+        if (from >= vex_size || to >= vex_size) return fallback;
+        return cell(from, to);
     }
-    template<class... Args>
-    index_type emplaceNode(Args&&... args) {
-        storage_provider.sync(index_provider.size() + 1);
-        index_type idx = index_provider.emplace(std::forward<Args>(args)...);
-        storage_provider.addIndex(idx);
-        return idx;
+
+    /**
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(index_type from, index_type to, const weight_type& weight) {
+        if (from >= vex_size || to >= vex_size) return ;
+        if (cell(from, to) == null_weight::value()) return ;
+        cell(from, to) = weight;
+        if constexpr (!_Directed) cell(to, from) = weight;
     }
-    index_type removeNode(const index_type& idx) {
-        const index_type& ret = storage_provider.removeIndex(idx);
-        if (ret != idx_limit::max()) {
-            index_provider.at(idx) = index_provider.at(ret);
-            index_provider.remove(ret);
-            index_provider.rewind(ret);
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(index_type idx, contain_type& contain) const {
+        for (auto pair: forthRange(idx)) contain.push_back(pair);
+    }
+
+    /**
+     * [StorageProvider.getBack]
+     */
+    void getBack(index_type idx, contain_type& contain) const {
+        for (auto pair: backRange(idx)) contain.push_back(pair);
+    }
+
+    // strided walk over a row (step 1) or a column (step cap)
+    struct stride_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        weight_type* base;
+        size_t step, pos, end;
+
+        void seek() {
+            while (pos < end && base[pos * step] == null_weight::value()) ++pos;
+        }
+        bool done() const { return pos >= end; }
+        void next() { ++pos; seek(); }
+        index_type index() const { return static_cast<index_type>(pos); }
+        weight_type* weight() const { return base + pos * step; }
+    };
+
+    /**
+     * 出边的惰性区间
+     */
+    utils::AdjacentRange<stride_cursor> forthRange(index_type idx) const {
+        stride_cursor cursor{nullptr, 1, 0, 0};
+        if (static_cast<size_t>(idx) < vex_size) {
+            cursor.base = cells.get() + static_cast<size_t>(idx) * cap;
+            cursor.end = vex_size;
+            cursor.seek();
+        }
+        return utils::AdjacentRange<stride_cursor>(cursor);
+    }
+
+    /**
+     * 入边的惰性区间
+     */
+    utils::AdjacentRange<stride_cursor> backRange(index_type idx) const {
+        stride_cursor cursor{nullptr, cap, 0, 0};
+        if (static_cast<size_t>(idx) < vex_size) {
+            cursor.base = cells.get() + static_cast<size_t>(idx);
+            cursor.end = vex_size;
+            cursor.seek();
+        }
+        return utils::AdjacentRange<stride_cursor>(cursor);
+    }
+};
+
+/**
+ * 位矩阵存储，面向无权（bool 权重）的稠密图。
+ *
+ * 所有行存放在同一块连续的 64 位字数组中，第 v 行占据
+ * [v * stride, (v + 1) * stride) 个字，stride 按几何级数增长。
+ * 邻接点的枚举使用 countr_zero 跳过空位，公共邻居与三角形计数
+ * 对两行做逐字的与运算后 popcount。
+ *
+ * 权重是隐式的：惰性区间的权重指针指向游标自带的 true，只在游标存活期间有效；
+ * getForth / getBack 的权重指针共同指向本存储的一个占位值，每次调用时重置为 true。
+ * 写入这些指针不会改变任何边，只影响此前取得、尚未重新获取的结果；
+ * 请通过 addEdge / removeEdge / setWeight 修改边。
+ */
+template<
+    DSL_MACRO_MATRIX_INDEX _IdxTp,
+    bool _Directed
+>
+class BitMatrixStorage {
+public:
+    typedef _IdxTp index_type;
+    typedef bool weight_type;
+    typedef std::vector<uint64_t> storage_type;
+    typedef std::tuple<index_type, index_type, weight_type> edge_type;
+    typedef utils::null_weight<weight_type> null_weight;
+
+    static constexpr weight_type fallback = null_weight::value();
+
+private:
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef utils::index_limits<index_type> idx_limit;
+
+    static constexpr weight_type present = true;
+
+    storage_type words;
+    size_t vex_size, stride, edge_count;
+    // target of the weight pointers in getForth / getBack, restored on every call
+    mutable weight_type placeholder = true;
+
+    // only stores after a caller wrote through a handed-out pointer
+    weight_type* restored() const {
+        if (!placeholder) placeholder = true;
+        return &placeholder;
+    }
+
+    uint64_t* row_ptr(size_t v) { return words.data() + v * stride; }
+    const uint64_t* row_ptr(size_t v) const { return words.data() + v * stride; }
+
+    bool test(size_t from, size_t to) const {
+        return (row_ptr(from)[to >> 6] >> (to & 63)) & 1;
+    }
+    void assign(size_t from, size_t to, bool bit) {
+        uint64_t& word = row_ptr(from)[to >> 6];
+        uint64_t mask = uint64_t(1) << (to & 63);
+        word = bit ? (word | mask) : (word & ~mask);
+    }
+
+    // set (from, to) and its mirror, keeping edge_count in step
+    void put(size_t from, size_t to, bool bit) {
+        if (from >= vex_size || to >= vex_size) return ;
+        if (test(from, to) == bit) return ;
+        assign(from, to, bit);
+        if constexpr (!_Directed) assign(to, from, bit);
+        if (bit) ++edge_count;
+        else --edge_count;
+    }
+
+    // make room for v_size rows and columns, growing both geometrically
+    void reserve_for(size_t v_size) {
+        size_t need = (v_size + 63) >> 6;
+        size_t rows = stride == 0 ? 0 : words.size() / stride;
+        if (need <= stride && v_size <= rows) return ;
+        size_t next_stride = need > stride ? std::max(need, stride * 2) : stride;
+        size_t next_rows = v_size > rows ? std::max(v_size, rows * 2) : rows;
+        if (next_stride == stride) {
+            words.resize(next_rows * stride, 0);
+            return ;
+        }
+        storage_type grown(next_rows * next_stride, 0);
+        for (size_t v = 0; v < vex_size; ++v) {
+            std::copy_n(row_ptr(v), stride, grown.data() + v * next_stride);
+        }
+        words.swap(grown);
+        stride = next_stride;
+    }
+
+    // popcount of row a AND row b over columns [from, vex_size)
+    size_t and_count(size_t a, size_t b, size_t from = 0) const {
+        const uint64_t* ra = row_ptr(a);
+        const uint64_t* rb = row_ptr(b);
+        size_t first = from >> 6, last = (vex_size + 63) >> 6;
+        if (first >= last) return 0;
+        size_t count = std::popcount(
+            ra[first] & rb[first] & (~uint64_t(0) << (from & 63))
+        );
+        for (size_t w = first + 1; w < last; ++w) count += std::popcount(ra[w] & rb[w]);
+        return count;
+    }
+
+public:
+#ifdef DSL_DEBUG
+
+    void _show() const {
+        std::cout << "Bit Matrix:\n";
+        for (size_t i = 0; i < vex_size; ++i) {
+            for (size_t j = 0; j < vex_size; ++j) std::cout << test(i, j) << ' ';
+            std::cout << '\n';
+        }
+        std::cout << "Vex Size: " << vex_size
+            << "\tEdge Count: " << edge_count << '\n';
+    }
+
+#endif
+
+    BitMatrixStorage(): words(), vex_size(0), stride(0), edge_count(0) { }
+
+    size_t size() const { return edge_count; }
+
+    /**
+     * 每行占用的 64 位字数，行 v 起始于 expose()->data() + v * rowStride()
+     */
+    size_t rowStride() const { return stride; }
+
+    /**
+     * 第 idx 行的位向量，越界时返回空指针
+     */
+    const uint64_t* row(index_type idx) const {
+        return static_cast<size_t>(idx) < vex_size ? row_ptr(idx) : nullptr;
+    }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return &words; }
+
+    /**
+     * Sync storage structure with vertex count of current graph
+     * [StorageProvider.sync]
+     */
+    void sync(size_t v_size) {
+        if (v_size >= vex_size) {
+            reserve_for(v_size);
+            vex_size = v_size;
+            return ;
+        }
+        // squeeze: clear columns and rows beyond the new size
+        for (size_t i = 0; i < v_size; ++i) {
+            for (size_t j = v_size; j < vex_size; ++j) assign(i, j, false);
+        }
+        std::fill(
+            words.begin() + v_size * stride,
+            words.begin() + vex_size * stride, 0
+        );
+        vex_size = v_size;
+    }
+
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(index_type) { }
+
+    /**
+     * Moves the last vertex into idx like MatrixStorage.
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(index_type idx) {
+        if (static_cast<size_t>(idx) >= vex_size) return idx_limit::max();
+        size_t v = static_cast<size_t>(idx), last = vex_size - 1;
+        const uint64_t* r = row_ptr(v);
+        size_t rm_edges = 0;
+        for (size_t w = 0; w < stride; ++w) rm_edges += std::popcount(r[w]);
+        if constexpr (_Directed) {
+            for (size_t i = 0; i < vex_size; ++i) rm_edges += test(i, v);
+            rm_edges -= test(v, v);
+        }
+        edge_count -= rm_edges;
+
+        if (v != last) {
+            std::copy_n(row_ptr(last), stride, row_ptr(v));
+            // after the row copy, (v, v) picks up the old (last, last)
+            for (size_t i = 0; i < vex_size; ++i) assign(i, v, test(i, last));
+        }
+        std::fill_n(row_ptr(last), stride, 0);
+        for (size_t i = 0; i < vex_size; ++i) assign(i, last, false);
+        return static_cast<index_type>(last);
+    }
+
+    /**
+     * A false weight removes the edge.
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(index_type from, index_type to, const weight_type& weight) {
+        put(from, to, weight);
+    }
+
+    /**
+     * Writes a sorted, duplicate-free edge list. Out-of-range edges are ignored.
+     */
+    void bulkLoad(const std::vector<edge_type>& edges) {
+        for (auto& [from, to, weight]: edges) put(from, to, weight);
+    }
+
+    /**
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(index_type from, index_type to) { put(from, to, false); }
+
+    /**
+     * [StorageProvider.getWeight]
+     */
+    const weight_type& getWeight(index_type from, index_type to) const {
+        if (from >= vex_size || to >= vex_size) return fallback;
+        return test(from, to) ? present : fallback;
+    }
+
+    /**
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(index_type from, index_type to, const weight_type& weight) {
+        put(from, to, weight);
+    }
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(index_type idx, contain_type& contain) const {
+        weight_type* mark = restored();
+        for (auto [v, wp]: forthRange(idx)) contain.emplace_back(v, mark);
+    }
+
+    /**
+     * [StorageProvider.getBack]
+     */
+    void getBack(index_type idx, contain_type& contain) const {
+        weight_type* mark = restored();
+        for (auto [v, wp]: backRange(idx)) contain.emplace_back(v, mark);
+    }
+
+    /**
+     * a 与 b 的公共出邻居数
+     */
+    size_t countCommon(index_type a, index_type b) const {
+        if (a >= vex_size || b >= vex_size) return 0;
+        return and_count(a, b);
+    }
+
+    /**
+     * a 与 b 的公共出邻居，按下标升序追加到 contain
+     */
+    void getCommon(
+        index_type a, index_type b,
+        std::vector<index_type>& contain
+    ) const {
+        if (a >= vex_size || b >= vex_size) return ;
+        const uint64_t* ra = row_ptr(a);
+        const uint64_t* rb = row_ptr(b);
+        for (size_t w = 0; w < stride; ++w) {
+            for (uint64_t bits = ra[w] & rb[w]; bits != 0; bits &= bits - 1) {
+                contain.push_back(
+                    static_cast<index_type>((w << 6) + std::countr_zero(bits))
+                );
+            }
+        }
+    }
+
+    /**
+     * 无向图中的三角形个数（忽略自环），对每条边 (u, v), u < v
+     * 统计两行在 v 之后的公共位。O(E * V / 64)
+     */
+    size_t countTriangles() const requires (!_Directed) {
+        size_t count = 0;
+        for (size_t u = 0; u < vex_size; ++u) {
+            for (auto [v, wp]: forthRange(static_cast<index_type>(u))) {
+                if (static_cast<size_t>(v) > u) count += and_count(u, v, v + 1);
+            }
+        }
+        return count;
+    }
+
+    // set bits of one row, lowest first
+    struct row_cursor {
+        typedef _IdxTp index_type;
+        typedef bool weight_type;
+        const uint64_t* row;
+        size_t word, words;
+        uint64_t bits;
+        mutable weight_type mark = true;
+
+        void seek() {
+            while (bits == 0 && ++word < words) bits = row[word];
+        }
+        bool done() const { return bits == 0; }
+        void next() { bits &= bits - 1; mark = true; seek(); }
+        index_type index() const {
+            return static_cast<index_type>((word << 6) + std::countr_zero(bits));
+        }
+        weight_type* weight() const { return &mark; }
+    };
+
+    // one column, tested row by row
+    struct column_cursor {
+        typedef _IdxTp index_type;
+        typedef bool weight_type;
+        const BitMatrixStorage* store;
+        size_t column, pos;
+        mutable weight_type mark = true;
+
+        void seek() {
+            while (pos < store->vex_size && !store->test(pos, column)) ++pos;
+        }
+        bool done() const { return pos >= store->vex_size; }
+        void next() { ++pos; mark = true; seek(); }
+        index_type index() const { return static_cast<index_type>(pos); }
+        weight_type* weight() const { return &mark; }
+    };
+
+    /**
+     * 结点的出边行，共 stride 个字，超出结点数的位均为 0；下标越界时为空
+     */
+    std::span<const uint64_t> rowWords(index_type idx) const {
+        if (static_cast<size_t>(idx) >= vex_size || stride == 0) return {};
+        return std::span<const uint64_t>(row_ptr(idx), stride);
+    }
+
+    /**
+     * 出边的惰性区间
+     */
+    utils::AdjacentRange<row_cursor> forthRange(index_type idx) const {
+        row_cursor cursor{nullptr, 0, 0, 0};
+        if (static_cast<size_t>(idx) < vex_size && stride != 0) {
+            cursor.row = row_ptr(idx);
+            cursor.words = stride;
+            cursor.bits = cursor.row[0];
+            cursor.seek();
+        }
+        return utils::AdjacentRange<row_cursor>(cursor);
+    }
+
+    /**
+     * 入边的惰性区间，有向图需要逐行检查该列
+     */
+    auto backRange(index_type idx) const {
+        if constexpr (!_Directed) {
+            return forthRange(idx);
         } else {
-            index_provider.remove(idx);
+            column_cursor cursor{this, static_cast<size_t>(idx), 0};
+            if (static_cast<size_t>(idx) >= vex_size) cursor.pos = vex_size;
+            cursor.seek();
+            return utils::AdjacentRange<column_cursor>(cursor);
         }
-        storage_provider.sync(index_provider.size());
-        return ret;
+    }
+};
+
+/**
+ * 按度数自适应的扁平邻接存储
+ * 每个结点的出边按度数选择三种表示之一：
+ * -# 度数不超过 inline_degree 时，边以有序数组的形式内嵌在结点的行中，不占用堆内存；
+ * -# 度数不超过 sorted_degree 时，边为堆上的有序数组，二分查找；
+ * -# 更高的度数使用 SwissTable 式的开放寻址表：每个槽一个控制字节，
+ *    保存哈希的低 7 位，查找时一次比较 16 个控制字节（SSE2 可用时为一条指令），
+ *    目标与权值各自连续存放，每条边只占用 sizeof(index_type) + sizeof(weight_type) 再加约 1/7 的空槽。
+ * 度数下降到阈值的一半以下时退回更紧凑的表示。
+ * 下标需为整数，结点的行按下标存放在数组中；
+ * 返回的权值指针在下一次改动该结点的邻接表或增加结点前有效。
+ * 包装进 ConcurrentStorage 时写边只锁两个端点的分片：行的重建会移动权值，
+ * 而 forthRange / backRange 在分片锁内把权值复制进快照，读者不会读到被移走的权值。
+ * @tparam _EnableBackIndex 是否为有向图维护入边索引，入边只记录起点，权值在起点的行中查找
+ */
+template<
+    DSL_MACRO_MATRIX_INDEX _IdxTp,
+    DSL_MACRO_WEIGHT_TYPE _WhtTp,
+    bool _Directed,
+    bool _EnableBackIndex = false
+>
+class FlatHashStorage {
+public:
+    typedef _IdxTp index_type;
+    typedef _WhtTp weight_type;
+    typedef std::tuple<index_type, index_type, weight_type> edge_type;
+    typedef utils::null_weight<weight_type> null_weight;
+
+    static constexpr weight_type fallback = null_weight::value();
+    static constexpr size_t inline_degree = 4;
+    static constexpr size_t sorted_degree = 64;
+
+    /**
+     * 单个结点的邻接表
+     * @tparam _ValTp 每条边附带的值，入边索引不带权值
+     */
+    template<class _ValTp>
+    class row {
+        friend class FlatHashStorage;
+
+        static constexpr size_t group = 16;
+        static constexpr int8_t empty = -128;
+        static constexpr int8_t deleted = -2;
+
+        enum kind_type: uint8_t { inline_kind, sorted_kind, table_kind };
+
+    public:
+        // boxed so that bool values are addressable in vectors too
+        struct cell { _ValTp value; };
+
+    private:
+
+        // heap part of the sorted and table forms; ctrl is empty when sorted
+        struct spill {
+            std::vector<index_type> keys;
+            std::vector<cell> values;
+            std::vector<int8_t> ctrl;
+            size_t tombstones = 0;
+        };
+
+        uint32_t count = 0;
+        kind_type kind = inline_kind;
+        std::array<index_type, inline_degree> small_keys{};
+        std::array<cell, inline_degree> small_values{};
+        std::unique_ptr<spill> heap;
+
+        static uint64_t hash_of(index_type key) {
+            uint64_t h = static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ull;
+            return h ^ (h >> 29);
+        }
+
+        // bit i set when ctrl[base + i] == tag
+        static uint32_t match(const int8_t* ctrl, int8_t tag) {
+#ifdef __SSE2__
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(tag))));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < group; ++i) mask |= uint32_t(ctrl[i] == tag) << i;
+            return mask;
+#endif
+        }
+
+        // slot of key in the table, ctrl.size() when absent
+        size_t table_find(const spill& s, index_type key) const {
+            size_t groups = s.ctrl.size() / group;
+            uint64_t h = hash_of(key);
+            int8_t tag = static_cast<int8_t>(h & 0x7f);
+            size_t g = (h >> 7) & (groups - 1);
+            for (size_t step = 0; step < groups; ++step) {
+                const int8_t* base = s.ctrl.data() + g * group;
+                for (uint32_t hits = match(base, tag); hits != 0; hits &= hits - 1) {
+                    size_t slot = g * group + std::countr_zero(hits);
+                    if (s.keys[slot] == key) return slot;
+                }
+                if (match(base, empty) != 0) break;
+                g = (g + step + 1) & (groups - 1);
+            }
+            return s.ctrl.size();
+        }
+
+        // first free slot on the probe sequence of key, the key is known to be absent
+        size_t table_slot(const spill& s, index_type key) const {
+            size_t groups = s.ctrl.size() / group;
+            uint64_t h = hash_of(key);
+            size_t g = (h >> 7) & (groups - 1);
+            for (size_t step = 0; ; ++step) {
+                const int8_t* base = s.ctrl.data() + g * group;
+                uint32_t free = match(base, empty) | match(base, deleted);
+                if (free != 0) return g * group + std::countr_zero(free);
+                g = (g + step + 1) & (groups - 1);
+            }
+        }
+
+        void table_put(spill& s, index_type key, _ValTp value) {
+            size_t slot = table_slot(s, key);
+            if (s.ctrl[slot] == deleted) --s.tombstones;
+            s.ctrl[slot] = static_cast<int8_t>(hash_of(key) & 0x7f);
+            s.keys[slot] = key;
+            s.values[slot].value = std::move(value);
+        }
+
+        // move every edge into the representation fitting capacity
+        void rebuild(size_t capacity) {
+            kind_type target = capacity <= inline_degree ? inline_kind :
+                capacity <= sorted_degree ? sorted_kind : table_kind;
+            std::vector<index_type> keys;
+            std::vector<cell> values;
+            keys.reserve(count);
+            values.reserve(count);
+            for_each([&](index_type k, _ValTp& v) {
+                keys.push_back(k);
+                values.push_back(cell{std::move(v)});
+            });
+            if (kind == table_kind && target != table_kind) {
+                // table order is arbitrary, sorted forms need ascending keys
+                std::vector<size_t> order(keys.size());
+                for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+                std::sort(order.begin(), order.end(), [&keys](size_t l, size_t r) {
+                    return keys[l] < keys[r];
+                });
+                std::vector<index_type> sorted_keys(keys.size());
+                std::vector<cell> sorted_values(keys.size());
+                for (size_t i = 0; i < order.size(); ++i) {
+                    sorted_keys[i] = keys[order[i]];
+                    sorted_values[i] = std::move(values[order[i]]);
+                }
+                keys.swap(sorted_keys);
+                values.swap(sorted_values);
+            }
+
+            kind = target;
+            if (target == inline_kind) {
+                heap.reset();
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    small_keys[i] = keys[i];
+                    small_values[i] = std::move(values[i]);
+                }
+                return ;
+            }
+            for (auto& c: small_values) c.value = _ValTp();
+            if (!heap) heap = std::make_unique<spill>();
+            heap->tombstones = 0;
+            if (target == sorted_kind) {
+                heap->ctrl.clear();
+                heap->ctrl.shrink_to_fit();
+                heap->keys = std::move(keys);
+                heap->values = std::move(values);
+                heap->keys.reserve(capacity);
+                heap->values.reserve(capacity);
+            } else {
+                // at most 7/8 of the slots in use
+                size_t slots = std::max<size_t>(std::bit_ceil(capacity * 8 / 7 + 1), group);
+                heap->ctrl.assign(slots, empty);
+                heap->keys.assign(slots, index_type());
+                heap->values.assign(slots, cell{});
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    table_put(*heap, keys[i], std::move(values[i].value));
+                }
+            }
+        }
+
+        // lower bound of key in the sorted forms
+        size_t rank(index_type key) const {
+            const index_type* keys = kind == inline_kind ? small_keys.data() : heap->keys.data();
+            return static_cast<size_t>(std::lower_bound(keys, keys + count, key) - keys);
+        }
+
+    public:
+        size_t size() const { return count; }
+
+        const _ValTp* find(index_type key) const {
+            if (kind == table_kind) {
+                size_t slot = table_find(*heap, key);
+                return slot < heap->ctrl.size() ? &heap->values[slot].value : nullptr;
+            }
+            size_t i = rank(key);
+            if (i == count) return nullptr;
+            if (kind == inline_kind) return small_keys[i] == key ? &small_values[i].value : nullptr;
+            return heap->keys[i] == key ? &heap->values[i].value : nullptr;
+        }
+        _ValTp* find(index_type key) {
+            return const_cast<_ValTp*>(static_cast<const row*>(this)->find(key));
+        }
+
+        /**
+         * 插入或覆盖，新插入时返回 true
+         */
+        bool put(index_type key, const _ValTp& value) {
+            if (_ValTp* found = find(key)) {
+                *found = value;
+                return false;
+            }
+            if (kind == inline_kind && count == inline_degree) rebuild(count + 1);
+            else if (kind == sorted_kind && count == sorted_degree) rebuild(count * 2);
+            else if (kind == table_kind) {
+                size_t used = count + heap->tombstones + 1;
+                if (used * 8 > heap->ctrl.size() * 7) rebuild((count + 1) * 2);
+            }
+            if (kind == table_kind) {
+                table_put(*heap, key, value);
+            } else if (kind == inline_kind) {
+                size_t i = rank(key);
+                for (size_t j = count; j > i; --j) {
+                    small_keys[j] = small_keys[j - 1];
+                    small_values[j] = std::move(small_values[j - 1]);
+                }
+                small_keys[i] = key;
+                small_values[i].value = value;
+            } else {
+                size_t i = rank(key);
+                heap->keys.insert(heap->keys.begin() + i, key);
+                heap->values.insert(heap->values.begin() + i, cell{value});
+            }
+            ++count;
+            return true;
+        }
+
+        /**
+         * 删除，存在时返回 true
+         */
+        bool erase(index_type key) {
+            if (kind == table_kind) {
+                size_t slot = table_find(*heap, key);
+                if (slot == heap->ctrl.size()) return false;
+                // a group with an empty slot never made a probe go further
+                const int8_t* base = heap->ctrl.data() + slot / group * group;
+                if (match(base, empty) != 0) {
+                    heap->ctrl[slot] = empty;
+                } else {
+                    heap->ctrl[slot] = deleted;
+                    ++heap->tombstones;
+                }
+                heap->values[slot].value = _ValTp();
+                --count;
+                if (count <= sorted_degree / 2) rebuild(count);
+                return true;
+            }
+            size_t i = rank(key);
+            if (i == count) return false;
+            if (kind == inline_kind) {
+                if (small_keys[i] != key) return false;
+                for (size_t j = i; j + 1 < count; ++j) {
+                    small_keys[j] = small_keys[j + 1];
+                    small_values[j] = std::move(small_values[j + 1]);
+                }
+                small_values[count - 1].value = _ValTp();
+                --count;
+                return true;
+            }
+            if (heap->keys[i] != key) return false;
+            heap->keys.erase(heap->keys.begin() + i);
+            heap->values.erase(heap->values.begin() + i);
+            --count;
+            if (count <= inline_degree / 2) rebuild(count);
+            return true;
+        }
+
+        /**
+         * 预留容量，直接切换到能容纳 capacity 条边的表示
+         */
+        void reserve(size_t capacity) {
+            if (capacity <= count) return ;
+            if (kind == inline_kind && capacity <= inline_degree) return ;
+            if (kind == sorted_kind && capacity <= sorted_degree) {
+                heap->keys.reserve(capacity);
+                heap->values.reserve(capacity);
+                return ;
+            }
+            if (kind == table_kind && capacity * 8 <= heap->ctrl.size() * 7) return ;
+            rebuild(capacity);
+        }
+
+        void clear() {
+            count = 0;
+            kind = inline_kind;
+            small_values.fill(cell{});
+            heap.reset();
+        }
+
+        /**
+         * 依次以 (key, value&) 调用 fn，有序表示按下标升序
+         */
+        template<class _Fn>
+        void for_each(_Fn&& fn) {
+            if (kind == inline_kind) {
+                for (size_t i = 0; i < count; ++i) fn(small_keys[i], small_values[i].value);
+            } else if (kind == sorted_kind) {
+                for (size_t i = 0; i < count; ++i) fn(heap->keys[i], heap->values[i].value);
+            } else {
+                for (size_t i = 0; i < heap->ctrl.size(); ++i) {
+                    if (heap->ctrl[i] >= 0) fn(heap->keys[i], heap->values[i].value);
+                }
+            }
+        }
+
+        row() = default;
+        row(row&&) = default;
+        row& operator= (row&&) = default;
+        row(const row& r):
+            count(r.count), kind(r.kind),
+            small_keys(r.small_keys), small_values(r.small_values),
+            heap(r.heap ? std::make_unique<spill>(*r.heap) : nullptr)
+        { }
+        row& operator= (const row& r) {
+            if (this != &r) *this = row(r);
+            return *this;
+        }
+
+        // contiguous view for the cursor: keys, values and ctrl (null when dense)
+        std::tuple<const index_type*, cell*, const int8_t*, size_t> raw() const {
+            auto* self = const_cast<row*>(this);
+            if (kind == inline_kind) {
+                return {small_keys.data(), self->small_values.data(), nullptr, count};
+            }
+            if (kind == sorted_kind) {
+                return {heap->keys.data(), self->heap->values.data(), nullptr, count};
+            }
+            return {heap->keys.data(), self->heap->values.data(), heap->ctrl.data(), heap->ctrl.size()};
+        }
+    };
+
+    // in-edge rows only record sources
+    struct no_value {
+        bool operator==(const no_value&) const = default;
+    };
+
+    typedef row<weight_type> forth_row;
+    typedef row<no_value> back_row;
+    typedef std::vector<forth_row> storage_type;
+
+private:
+    typedef FlatHashStorage<_IdxTp, _WhtTp, _Directed, _EnableBackIndex> self;
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef utils::index_limits<index_type> idx_limit;
+    static constexpr bool enable_bi = _Directed && _EnableBackIndex;
+
+    storage_type rows;
+    std::vector<back_row> back_rows;
+    // rows[i] is a vertex when alive[i]
+    std::vector<bool> alive;
+    size_t edge_count;
+
+    bool has(const index_type& idx) const {
+        size_t i = static_cast<size_t>(idx);
+        return i < alive.size() && alive[i];
+    }
+
+public:
+#ifdef DSL_DEBUG
+
+    void _show() const {
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (!alive[i]) continue;
+            std::cout << "|*" << i;
+            const_cast<forth_row&>(rows[i]).for_each([](index_type to, weight_type& weight) {
+                std::cout << " ->[" << to << ": " << weight << ']';
+            });
+            std::cout << '\n';
+        }
+        std::cout << "Edge Count: " << edge_count << '\n';
+    }
+
+#endif
+
+    FlatHashStorage(): rows(), back_rows(), alive(), edge_count(0) { }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return &rows; }
+
+    /**
+     * [StorageProvider.sync]
+     */
+    void sync(size_t) { }
+
+    size_t size() const { return edge_count; }
+
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(const index_type& idx) {
+        size_t i = static_cast<size_t>(idx);
+        if (i >= rows.size()) {
+            rows.resize(i + 1);
+            alive.resize(i + 1, false);
+            if constexpr (enable_bi) back_rows.resize(i + 1);
+        }
+        alive[i] = true;
+    }
+
+    /**
+     * O(deg) for undirected graphs or with the back index enabled,
+     * otherwise every row is searched.
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(const index_type& idx) {
+        if (!has(idx)) return idx_limit::max();
+        size_t i = static_cast<size_t>(idx);
+        size_t rm_edge = rows[i].size();
+        if constexpr (!_Directed) {
+            rows[i].for_each([&](index_type to, weight_type&) {
+                if (to != idx) rows[to].erase(idx);
+            });
+        } else if constexpr (enable_bi) {
+            rows[i].for_each([&](index_type to, weight_type&) {
+                if (to != idx) back_rows[to].erase(idx);
+            });
+            back_rows[i].for_each([&](index_type from, no_value&) {
+                if (from == idx) return ;
+                rows[from].erase(idx);
+                ++rm_edge;
+            });
+            back_rows[i].clear();
+        } else {
+            for (size_t j = 0; j < rows.size(); ++j) {
+                if (j != i && alive[j]) rm_edge += rows[j].erase(idx);
+            }
+        }
+        rows[i].clear();
+        alive[i] = false;
+        edge_count -= rm_edge;
+        return idx_limit::max();
+    }
+
+    /**
+     * Will not add edge if any of the indexes does not exist.
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        if (!has(from) || !has(to)) return ;
+        if (rows[from].put(to, weight)) {
+            if constexpr (enable_bi) back_rows[to].put(from, no_value());
+            ++edge_count;
+        }
+        if constexpr (!_Directed) rows[to].put(from, weight);
+    }
+
+    /**
+     * 批量加入边，edges 须按 (from, to) 排序且无重复，无向边只给出一次。
+     * 先按度数预留各行的容量，高度数结点直接建成哈希表。
+     * 端点不存在的边被忽略。
+     */
+    void bulkLoad(const std::vector<edge_type>& edges) {
+        std::vector<size_t> degree(rows.size(), 0), back_degree;
+        if constexpr (enable_bi) back_degree.assign(rows.size(), 0);
+        for (auto& [from, to, weight]: edges) {
+            if (!has(from) || !has(to)) continue;
+            ++degree[from];
+            if constexpr (!_Directed) ++degree[to];
+            if constexpr (enable_bi) ++back_degree[to];
+        }
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (degree[i] != 0) rows[i].reserve(rows[i].size() + degree[i]);
+            if constexpr (enable_bi) {
+                if (back_degree[i] != 0) back_rows[i].reserve(back_rows[i].size() + back_degree[i]);
+            }
+        }
+        for (auto& [from, to, weight]: edges) addEdge(from, to, weight);
+    }
+
+    /**
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(
+        const index_type& from,
+        const index_type& to
+    ) {
+        if (!has(from) || !has(to)) return ;
+        if (!rows[from].erase(to)) return ;
+        if constexpr (enable_bi) back_rows[to].erase(from);
+        if constexpr (!_Directed) rows[to].erase(from);
+        --edge_count;
+    }
+
+    /**
+     * [StorageProvider.getWeight]
+     */
+    const weight_type& getWeight(
+        const index_type& from,
+        const index_type& to
+    ) const {
+        if (!has(from)) return fallback;
+        const weight_type* found = rows[from].find(to);
+        return found == nullptr ? fallback : *found;
+    }
+
+    /**
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        if (!has(from) || !has(to)) return ;
+        weight_type* found = rows[from].find(to);
+        if (found == nullptr) return ;
+        *found = weight;
+        if constexpr (!_Directed) *rows[to].find(from) = weight;
+    }
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(
+        const index_type& idx,
+        contain_type& contain
+    ) const {
+        for (auto pair: forthRange(idx)) contain.push_back(pair);
+    }
+
+    /**
+     * O(deg) for undirected graphs or with the back index enabled.
+     * [StorageProvider.getBack]
+     */
+    void getBack(
+        const index_type& idx,
+        contain_type& contain
+    ) const {
+        for (auto pair: backRange(idx)) contain.push_back(pair);
+    }
+
+    // walks a row's arrays, skipping free table slots
+    struct row_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        const index_type* keys = nullptr;
+        typename forth_row::cell* values = nullptr;
+        const int8_t* ctrl = nullptr;
+        size_t pos = 0, end = 0;
+
+        void seek() { if (ctrl != nullptr) while (pos < end && ctrl[pos] < 0) ++pos; }
+        bool done() const { return pos >= end; }
+        void next() { ++pos; seek(); }
+        index_type index() const { return keys[pos]; }
+        weight_type* weight() const { return &values[pos].value; }
+    };
+
+    // in-edges from the back index, weights looked up in the source rows
+    struct back_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        const self* store = nullptr;
+        index_type target{};
+        const index_type* keys = nullptr;
+        const int8_t* ctrl = nullptr;
+        size_t pos = 0, end = 0;
+
+        void seek() { if (ctrl != nullptr) while (pos < end && ctrl[pos] < 0) ++pos; }
+        bool done() const { return pos >= end; }
+        void next() { ++pos; seek(); }
+        index_type index() const { return keys[pos]; }
+        weight_type* weight() const {
+            return const_cast<weight_type*>(store->rows[keys[pos]].find(target));
+        }
+    };
+
+    // in-edges without back index: search every row
+    struct scan_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        const self* store = nullptr;
+        index_type target{};
+        size_t pos = 0;
+        weight_type* found = nullptr;
+
+        void seek() {
+            for (; pos < store->rows.size(); ++pos) {
+                if (!store->alive[pos]) continue;
+                found = const_cast<weight_type*>(store->rows[pos].find(target));
+                if (found != nullptr) return ;
+            }
+        }
+        bool done() const { return pos >= store->rows.size(); }
+        void next() { ++pos; seek(); }
+        index_type index() const { return static_cast<index_type>(pos); }
+        weight_type* weight() const { return found; }
+    };
+
+    /**
+     * 出边的惰性区间
+     */
+    utils::AdjacentRange<row_cursor> forthRange(const index_type& idx) const {
+        row_cursor cursor;
+        if (has(idx)) {
+            auto [keys, values, ctrl, end] = rows[idx].raw();
+            cursor.keys = keys;
+            cursor.values = values;
+            cursor.ctrl = ctrl;
+            cursor.end = end;
+            cursor.seek();
+        }
+        return utils::AdjacentRange<row_cursor>(cursor);
+    }
+
+    /**
+     * 入边的惰性区间
+     * 未开启入边索引的有向图需要扫描所有结点
+     */
+    auto backRange(const index_type& idx) const {
+        if constexpr (!_Directed) {
+            return forthRange(idx);
+        } else if constexpr (enable_bi) {
+            back_cursor cursor;
+            cursor.store = this;
+            cursor.target = idx;
+            if (has(idx)) {
+                auto [keys, values, ctrl, end] = back_rows[idx].raw();
+                cursor.keys = keys;
+                cursor.ctrl = ctrl;
+                cursor.end = end;
+                cursor.seek();
+            }
+            return utils::AdjacentRange<back_cursor>(cursor);
+        } else {
+            scan_cursor cursor{this, idx, 0, nullptr};
+            cursor.seek();
+            return utils::AdjacentRange<scan_cursor>(cursor);
+        }
+    }
+};
+
+/**
+ * 压缩稀疏行（CSR）存储，面向只读的大规模稀疏图。
+ *
+ * 存储分为两个阶段：
+ * -# 构建阶段：addEdge / removeEdge 作用于暂存的边表，
+ *    读操作退化为对边表的线性扫描；
+ * -# 冻结阶段：调用 freeze() 或 build() 后，边表被整理为连续的
+ *    offsets / targets / weights 数组，每个顶点的出边为其中的一段，
+ *    段内按终点下标升序排列。此后拓扑结构不再改变（addEdge / removeEdge
+ *    被忽略），只允许通过 setWeight 修改已有边的权重。
+ *
+ * 有向图在冻结时额外构建按终点分组的反向索引，getBack 同样为一段线性扫描；
+ * 无向图的每条边在两个端点的段中各存一份。
+ */
+template<
+    DSL_MACRO_MATRIX_INDEX _IdxTp,
+    DSL_MACRO_WEIGHT_TYPE _WhtTp,
+    bool _Directed
+>
+class CsrStorage {
+public:
+    typedef _IdxTp index_type;
+    typedef _WhtTp weight_type;
+    typedef std::tuple<index_type, index_type, weight_type> edge_type;
+    typedef utils::null_weight<weight_type> null_weight;
+
+    /**
+     * 冻结后的 CSR 数组
+     * 顶点 v 的出边为 [offsets[v], offsets[v + 1]) 区间内的
+     * targets 与 weights
+     */
+    struct storage_type {
+        std::vector<size_t> offsets;
+        std::vector<index_type> targets;
+        // accessors hand out mutable weight pointers from const storage
+        mutable std::vector<weight_type> weights;
+    };
+
+    static constexpr weight_type fallback = null_weight::value();
+
+private:
+    typedef CsrStorage<_IdxTp, _WhtTp, _Directed> self;
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef utils::index_limits<index_type> idx_limit;
+
+    storage_type csr;
+    // reverse index of directed graph, grouped by target
+    std::vector<size_t> rev_offsets;
+    std::vector<index_type> rev_sources;
+    std::vector<size_t> rev_slots;
+    // edges added before freeze
+    mutable std::vector<edge_type> pending;
+    size_t vex_size, edge_count;
+    bool frozen;
+
+    void clear_up() {
+        csr.offsets.clear();
+        csr.targets.clear();
+        csr.weights.clear();
+        rev_offsets.clear();
+        rev_sources.clear();
+        rev_slots.clear();
+        pending.clear();
+        vex_size = 0;
+        edge_count = 0;
+        frozen = false;
+    }
+
+    /**
+     * Position of edge (from, to) in csr arrays, or targets.size()
+     * Binary search inside the sorted slice of `from`.
+     */
+    size_t locate(index_type from, index_type to) const {
+        if (static_cast<size_t>(from) >= vex_size) return csr.targets.size();
+        auto beg = csr.targets.cbegin() + csr.offsets[from];
+        auto end = csr.targets.cbegin() + csr.offsets[from + 1];
+        auto iter = std::lower_bound(beg, end, to);
+        if (iter == end || *iter != to) return csr.targets.size();
+        return static_cast<size_t>(iter - csr.targets.cbegin());
+    }
+
+    // grow vertex range, new vertices come with empty slices
+    void extend(size_t v_size) {
+        if (v_size <= vex_size) return ;
+        vex_size = v_size;
+        if (!frozen) return ;
+        csr.offsets.resize(vex_size + 1, csr.targets.size());
+        if constexpr (_Directed) {
+            rev_offsets.resize(vex_size + 1, rev_sources.size());
+        }
+    }
+
+    void build_reverse() {
+        rev_offsets.assign(vex_size + 1, 0);
+        rev_sources.resize(csr.targets.size());
+        rev_slots.resize(csr.targets.size());
+        for (auto to: csr.targets) ++rev_offsets[to + 1];
+        for (size_t i = 0; i < vex_size; ++i) {
+            rev_offsets[i + 1] += rev_offsets[i];
+        }
+        std::vector<size_t> cursor(
+            rev_offsets.cbegin(), rev_offsets.cend() - 1
+        );
+        for (size_t from = 0; from < vex_size; ++from) {
+            for (size_t e = csr.offsets[from]; e < csr.offsets[from + 1]; ++e) {
+                size_t pos = cursor[csr.targets[e]]++;
+                rev_sources[pos] = static_cast<index_type>(from);
+                rev_slots[pos] = e;
+            }
+        }
+    }
+
+    // collect frozen edges back to pending (each undirected edge once)
+    void dump_pending() {
+        pending.clear();
+        pending.reserve(edge_count);
+        for (size_t from = 0; from < vex_size; ++from) {
+            for (size_t e = csr.offsets[from]; e < csr.offsets[from + 1]; ++e) {
+                index_type to = csr.targets[e];
+                if constexpr (!_Directed) {
+                    if (static_cast<size_t>(to) < from) continue;
+                }
+                pending.emplace_back(
+                    static_cast<index_type>(from), to, csr.weights[e]
+                );
+            }
+        }
+        csr.offsets.clear();
+        csr.targets.clear();
+        csr.weights.clear();
+        rev_offsets.clear();
+        rev_sources.clear();
+        rev_slots.clear();
+        frozen = false;
+    }
+
+public:
+#ifdef DSL_DEBUG
+
+    void _show() const {
+        if (!frozen) {
+            std::cout << "CSR (building):\n";
+            for (auto& [from, to, weight]: pending) {
+                std::cout << from << " ->[" << to << ": " << weight << "]\n";
+            }
+        } else {
+            std::cout << "CSR (frozen):\n";
+            for (size_t i = 0; i < vex_size; ++i) {
+                std::cout << "|*" << i;
+                for (size_t e = csr.offsets[i]; e < csr.offsets[i + 1]; ++e) {
+                    std::cout << " ->[" << csr.targets[e] << ": "
+                        << csr.weights[e] << ']';
+                }
+                std::cout << '\n';
+            }
+        }
+        std::cout << "Vex Size: " << vex_size
+            << "\tEdge Count: " << edge_count << '\n';
+    }
+
+#endif
+
+    CsrStorage():
+        csr(), rev_offsets(), rev_sources(), rev_slots(), pending(),
+        vex_size(0), edge_count(0), frozen(false)
+    { }
+
+    /**
+     * 整理暂存边表为 CSR 数组并冻结拓扑结构
+     * 重复的边保留最后一次加入时的权重
+     * O(V + E log d)，d 为最大出度
+     */
+    void freeze() {
+        if (frozen) return ;
+        // counting sort edges by source, keeping insertion order per row
+        std::vector<size_t> degree(vex_size + 1, 0);
+        for (auto& [from, to, weight]: pending) {
+            ++degree[from + 1];
+            if constexpr (!_Directed) {
+                if (from != to) ++degree[to + 1];
+            }
+        }
+        for (size_t i = 0; i < vex_size; ++i) degree[i + 1] += degree[i];
+        std::vector<std::pair<index_type, weight_type>> rows(degree[vex_size]);
+        std::vector<size_t> cursor(degree.cbegin(), degree.cend() - 1);
+        for (auto& [from, to, weight]: pending) {
+            rows[cursor[from]++] = std::make_pair(to, weight);
+            if constexpr (!_Directed) {
+                if (from != to) rows[cursor[to]++] = std::make_pair(from, weight);
+            }
+        }
+        pending.clear();
+        pending.shrink_to_fit();
+
+        // sort each slice by target and drop duplicates (last one wins)
+        csr.offsets.assign(vex_size + 1, 0);
+        csr.targets.clear();
+        csr.weights.clear();
+        csr.targets.reserve(rows.size());
+        csr.weights.reserve(rows.size());
+        size_t self_loops = 0;
+        for (size_t v = 0; v < vex_size; ++v) {
+            auto beg = rows.begin() + degree[v];
+            auto end = rows.begin() + degree[v + 1];
+            std::stable_sort(beg, end, [](const auto& l, const auto& r) {
+                return l.first < r.first;
+            });
+            for (auto iter = beg; iter != end; ++iter) {
+                auto next = iter + 1;
+                if (next != end && next->first == iter->first) continue;
+                csr.targets.push_back(iter->first);
+                csr.weights.push_back(iter->second);
+                if (static_cast<size_t>(iter->first) == v) ++self_loops;
+            }
+            csr.offsets[v + 1] = csr.targets.size();
+        }
+        if constexpr (_Directed) {
+            edge_count = csr.targets.size();
+        } else {
+            edge_count = (csr.targets.size() + self_loops) / 2;
+        }
+        frozen = true;
+        if constexpr (_Directed) build_reverse();
+    }
+
+    /**
+     * 以给定的顶点数与边表整体重建存储并冻结
+     * 边表元素为 (from, to, weight)，越界的边被忽略
+     */
+    void build(size_t v_size, const std::vector<edge_type>& edges) {
+        clear_up();
+        vex_size = v_size;
+        pending.reserve(edges.size());
+        for (auto& edge: edges) {
+            if (
+                static_cast<size_t>(std::get<0>(edge)) >= vex_size ||
+                static_cast<size_t>(std::get<1>(edge)) >= vex_size
+            ) continue;
+            pending.push_back(edge);
+        }
+        freeze();
+    }
+
+    /**
+     * 批量加入边并冻结，edges 须按 (from, to) 排序且无重复，无向边只给出一次
+     * 存储为空时直接按序写出 CSR 数组，不再排序；
+     * 否则与已有的边合并后重新冻结。越界的边被忽略。
+     */
+    void bulkLoad(const std::vector<edge_type>& edges) {
+        if (!(pending.empty() && (!frozen || csr.targets.empty()))) {
+            if (frozen) dump_pending();
+            pending.reserve(pending.size() + edges.size());
+            for (auto& edge: edges) {
+                addEdge(std::get<0>(edge), std::get<1>(edge), std::get<2>(edge));
+            }
+            freeze();
+            return ;
+        }
+
+        std::vector<size_t> degree(vex_size + 1, 0);
+        for (auto& [from, to, weight]: edges) {
+            if (
+                static_cast<size_t>(from) >= vex_size ||
+                static_cast<size_t>(to) >= vex_size
+            ) continue;
+            ++degree[from + 1];
+            if constexpr (!_Directed) {
+                if (from != to) ++degree[to + 1];
+            }
+        }
+        for (size_t i = 0; i < vex_size; ++i) degree[i + 1] += degree[i];
+        csr.offsets = degree;
+        csr.targets.resize(degree[vex_size]);
+        csr.weights.resize(degree[vex_size]);
+        // rows come out sorted: for undirected row v the mirrored sources
+        // (< v) are all written before the edges starting at v
+        std::vector<size_t> cursor(degree.cbegin(), degree.cend() - 1);
+        size_t self_loops = 0;
+        for (auto& [from, to, weight]: edges) {
+            if (
+                static_cast<size_t>(from) >= vex_size ||
+                static_cast<size_t>(to) >= vex_size
+            ) continue;
+            size_t pos = cursor[from]++;
+            csr.targets[pos] = to;
+            csr.weights[pos] = weight;
+            if constexpr (!_Directed) {
+                if (from == to) { ++self_loops; continue; }
+                pos = cursor[to]++;
+                csr.targets[pos] = from;
+                csr.weights[pos] = weight;
+            }
+        }
+        if constexpr (_Directed) {
+            edge_count = csr.targets.size();
+        } else {
+            edge_count = (csr.targets.size() + self_loops) / 2;
+        }
+        frozen = true;
+        if constexpr (_Directed) build_reverse();
+    }
+
+    bool isFrozen() const { return frozen; }
+
+    size_t size() const {
+        return frozen ? edge_count : pending.size();
+    }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return &csr; }
+
+    /**
+     * Only grows vertex range, removed indexes are never reused here
+     * [StorageProvider.sync]
+     */
+    void sync(size_t v_size) { extend(v_size); }
+
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(const index_type& idx) {
+        extend(static_cast<size_t>(idx) + 1);
+    }
+
+    /**
+     * Drops all edges adjacent to idx. On a frozen storage
+     * this rebuilds the arrays, costing O(V + E).
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(const index_type& idx) {
+        if (static_cast<size_t>(idx) >= vex_size) return idx_limit::max();
+        bool was_frozen = frozen;
+        if (frozen) dump_pending();
+        std::erase_if(pending, [&idx](const edge_type& edge) {
+            return std::get<0>(edge) == idx || std::get<1>(edge) == idx;
+        });
+        if (was_frozen) freeze();
+        return idx_limit::max();
+    }
+
+    /**
+     * Ignored once frozen or if any of the indexes does not exist.
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        if (frozen) return ;
+        if (
+            static_cast<size_t>(from) >= vex_size ||
+            static_cast<size_t>(to) >= vex_size
+        ) return ;
+        pending.emplace_back(from, to, weight);
+    }
+
+    /**
+     * Ignored once frozen. O(E) while building.
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(
+        const index_type& from,
+        const index_type& to
+    ) {
+        if (frozen) return ;
+        std::erase_if(pending, [&from, &to](const edge_type& edge) {
+            auto& [f, t, w] = edge;
+            if constexpr (_Directed) {
+                return f == from && t == to;
+            } else {
+                return (f == from && t == to) || (f == to && t == from);
+            }
+        });
+    }
+
+    /**
+     * [StorageProvider.getWeight]
+     */
+    const weight_type& getWeight(
+        const index_type& from,
+        const index_type& to
+    ) const {
+        if (frozen) {
+            size_t pos = locate(from, to);
+            if (pos == csr.targets.size()) return fallback;
+            return csr.weights[pos];
+        }
+        for (auto iter = pending.crbegin(); iter != pending.crend(); ++iter) {
+            auto& [f, t, w] = *iter;
+            if (f == from && t == to) return w;
+            if constexpr (!_Directed) {
+                if (f == to && t == from) return w;
+            }
+        }
+        return fallback;
+    }
+
+    /**
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        if (frozen) {
+            size_t pos = locate(from, to);
+            if (pos == csr.targets.size()) return ;
+            csr.weights[pos] = weight;
+            if constexpr (!_Directed) {
+                pos = locate(to, from);
+                if (pos != csr.targets.size()) csr.weights[pos] = weight;
+            }
+            return ;
+        }
+        for (auto& [f, t, w]: pending) {
+            if (f == from && t == to) w = weight;
+            if constexpr (!_Directed) {
+                if (f == to && t == from) w = weight;
+            }
+        }
+    }
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(
+        const index_type& idx,
+        contain_type& contain
+    ) const {
+        if (static_cast<size_t>(idx) >= vex_size) return ;
+        if (frozen) {
+            size_t end = csr.offsets[idx + 1];
+            for (size_t e = csr.offsets[idx]; e < end; ++e) {
+                contain.emplace_back(csr.targets[e], &(csr.weights[e]));
+            }
+            return ;
+        }
+        for (auto& [f, t, w]: pending) {
+            if (f == idx) {
+                contain.emplace_back(t, &w);
+            } else if constexpr (!_Directed) {
+                if (t == idx) contain.emplace_back(f, &w);
+            }
+        }
+    }
+
+    /**
+     * [StorageProvider.getBack]
+     */
+    void getBack(
+        const index_type& idx,
+        contain_type& contain
+    ) const {
+        if constexpr (!_Directed) {
+            getForth(idx, contain);
+        } else {
+            if (static_cast<size_t>(idx) >= vex_size) return ;
+            if (frozen) {
+                size_t end = rev_offsets[idx + 1];
+                for (size_t e = rev_offsets[idx]; e < end; ++e) {
+                    contain.emplace_back(
+                        rev_sources[e], &(csr.weights[rev_slots[e]])
+                    );
+                }
+                return ;
+            }
+            for (auto& [f, t, w]: pending) {
+                if (t == idx) contain.emplace_back(f, &w);
+            }
+        }
+    }
+
+    /**
+     * Frozen: walks ids[pos, end) with weights[slots[pos]] (or weights[pos]).
+     * Building: scans the pending edge list like getForth / getBack.
+     */
+    struct csr_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        bool building, backward;
+        const index_type* ids;
+        const size_t* slots;
+        weight_type* weights;
+        size_t pos, end;
+        edge_type* edge;
+        edge_type* edge_end;
+        index_type target, current;
+
+        bool match() {
+            auto& [f, t, w] = *edge;
+            if (!(_Directed && backward) && f == target) {
+                current = t;
+                return true;
+            }
+            if ((!_Directed || backward) && t == target) {
+                current = f;
+                return true;
+            }
+            return false;
+        }
+        void seek() {
+            if (!building) return ;
+            while (edge != edge_end && !match()) ++edge;
+        }
+        bool done() const { return building ? edge == edge_end : pos >= end; }
+        void next() {
+            if (building) { ++edge; seek(); }
+            else ++pos;
+        }
+        index_type index() const { return building ? current : ids[pos]; }
+        weight_type* weight() const {
+            if (building) return &std::get<2>(*edge);
+            return weights + (slots == nullptr ? pos : slots[pos]);
+        }
+    };
+
+private:
+    csr_cursor make_cursor(const index_type& idx, bool backward) const {
+        csr_cursor cursor{};
+        cursor.backward = backward;
+        if (static_cast<size_t>(idx) >= vex_size) return cursor;
+        if (!frozen) {
+            cursor.building = true;
+            cursor.edge = pending.data();
+            cursor.edge_end = pending.data() + pending.size();
+            cursor.target = idx;
+            cursor.seek();
+        } else if (_Directed && backward) {
+            cursor.ids = rev_sources.data();
+            cursor.slots = rev_slots.data();
+            cursor.weights = csr.weights.data();
+            cursor.pos = rev_offsets[idx];
+            cursor.end = rev_offsets[idx + 1];
+        } else {
+            cursor.ids = csr.targets.data();
+            cursor.weights = csr.weights.data();
+            cursor.pos = csr.offsets[idx];
+            cursor.end = csr.offsets[idx + 1];
+        }
+        return cursor;
+    }
+
+public:
+    /**
+     * 出边的惰性区间，冻结后为一段连续数组
+     */
+    utils::AdjacentRange<csr_cursor> forthRange(const index_type& idx) const {
+        return utils::AdjacentRange<csr_cursor>(make_cursor(idx, false));
+    }
+
+    /**
+     * 入边的惰性区间
+     */
+    utils::AdjacentRange<csr_cursor> backRange(const index_type& idx) const {
+        return utils::AdjacentRange<csr_cursor>(make_cursor(idx, true));
+    }
+
+    /**
+     * 冻结后结点的出边终点，为 targets 中连续的一段；冻结前为空
+     */
+    std::span<const index_type> forthSpan(const index_type& idx) const {
+        if (!frozen || static_cast<size_t>(idx) >= vex_size) return {};
+        size_t beg = csr.offsets[idx], end = csr.offsets[idx + 1];
+        return std::span<const index_type>(csr.targets.data() + beg, end - beg);
+    }
+
+    /**
+     * 与 forthSpan 一一对应的权重
+     */
+    std::span<const weight_type> forthWeights(const index_type& idx) const {
+        if (!frozen || static_cast<size_t>(idx) >= vex_size) return {};
+        size_t beg = csr.offsets[idx], end = csr.offsets[idx + 1];
+        return std::span<const weight_type>(csr.weights.data() + beg, end - beg);
+    }
+
+    bool spansReady() const { return frozen; }
+};
+
+/**
+ * 维护连通分量的存储包装器
+ * 所有操作转发给 _StProv，同时用并查集跟踪（弱）连通分量：
+ * addIndex / addEdge 时增量合并，connected 等查询均摊 O(α(n))。
+ * 删除边或结点无法在并查集上撤销，只标记失效，
+ * 下一次查询时按现有的边重建，O(V + E)。
+ * 要求下标为整数。
+ */
+template<class _StProv>
+class ComponentStorage {
+public:
+    typedef typename _StProv::index_type index_type;
+    typedef typename _StProv::weight_type weight_type;
+    typedef typename _StProv::storage_type storage_type;
+    typedef typename _StProv::null_weight null_weight;
+
+    static constexpr weight_type fallback = _StProv::fallback;
+
+private:
+    static_assert(
+        std::is_integral_v<index_type>,
+        "ComponentStorage: index type should be integral"
+    );
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef utils::index_limits<index_type> idx_limit;
+
+    _StProv inner;
+    std::vector<bool> present;
+    mutable utils::DisjointSet<index_type> sets;
+    mutable bool stale;
+
+    bool has(index_type idx) const {
+        return static_cast<size_t>(idx) < present.size() && present[idx];
+    }
+
+    void rebuild() const {
+        sets.clear();
+        for (size_t v = 0; v < present.size(); ++v) {
+            if (present[v]) sets.add(static_cast<index_type>(v));
+        }
+        for (size_t v = 0; v < present.size(); ++v) {
+            if (!present[v]) continue;
+            for (auto [to, wp]: inner.forthRange(static_cast<index_type>(v))) {
+                sets.unite(static_cast<index_type>(v), to);
+            }
+        }
+        stale = false;
+    }
+
+public:
+    ComponentStorage(): inner(), present(), sets(), stale(false) { }
+
+    /**
+     * 被包装的存储，用于调用其特有的接口（如 CsrStorage::freeze）
+     */
+    _StProv& base() { return inner; }
+    const _StProv& base() const { return inner; }
+
+    size_t size() const requires requires(const _StProv& s) { s.size(); } {
+        return inner.size();
+    }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return inner.expose(); }
+
+    /**
+     * [StorageProvider.sync]
+     */
+    void sync(size_t v_size) { inner.sync(v_size); }
+
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(const index_type& idx) {
+        inner.addIndex(idx);
+        size_t i = static_cast<size_t>(idx);
+        if (i >= present.size()) present.resize(i + 1, false);
+        present[i] = true;
+        if (!stale) sets.add(idx);
+    }
+
+    /**
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(const index_type& idx) {
+        index_type ret = inner.removeIndex(idx);
+        // swap-removing providers move `ret` into `idx`
+        index_type gone = ret == idx_limit::max() ? idx : ret;
+        if (has(gone)) present[gone] = false;
+        stale = true;
+        return ret;
+    }
+
+    /**
+     * Null weights and frozen storages are settled by the next rebuild.
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        inner.addEdge(from, to, weight);
+        if constexpr (requires { inner.isFrozen(); }) {
+            if (inner.isFrozen()) return ;
+        }
+        if (weight == null_weight::value()) stale = true;
+        else if (!stale && has(from) && has(to)) sets.unite(from, to);
+    }
+
+    /**
+     * Edges are merged by a rebuild on the next query.
+     */
+    void bulkLoad(const std::vector<std::tuple<index_type, index_type, weight_type>>& edges) {
+        if constexpr (requires { inner.bulkLoad(edges); }) {
+            inner.bulkLoad(edges);
+        } else {
+            for (auto& [from, to, weight]: edges) inner.addEdge(from, to, weight);
+        }
+        stale = true;
+    }
+
+    /**
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(const index_type& from, const index_type& to) {
+        inner.removeEdge(from, to);
+        stale = true;
+    }
+
+    /**
+     * [StorageProvider.getWeight]
+     */
+    utils::weight_result_t<_StProv> getWeight(
+        const index_type& from,
+        const index_type& to
+    ) const {
+        return inner.getWeight(from, to);
+    }
+
+    /**
+     * Some providers treat a null weight as removal.
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        inner.setWeight(from, to, weight);
+        if (weight == null_weight::value()) stale = true;
+        else if (!stale && inner.getWeight(from, to) != null_weight::value()) {
+            sets.unite(from, to);
+        }
+    }
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(const index_type& idx, contain_type& contain) const {
+        inner.getForth(idx, contain);
+    }
+
+    /**
+     * [StorageProvider.getBack]
+     */
+    void getBack(const index_type& idx, contain_type& contain) const {
+        inner.getBack(idx, contain);
+    }
+
+    auto forthRange(const index_type& idx) const { return inner.forthRange(idx); }
+    auto backRange(const index_type& idx) const { return inner.backRange(idx); }
+
+    auto forthSpan(const index_type& idx) const
+    requires requires(const _StProv& s) { s.forthSpan(idx); } {
+        return inner.forthSpan(idx);
+    }
+    auto forthWeights(const index_type& idx) const
+    requires requires(const _StProv& s) { s.forthWeights(idx); } {
+        return inner.forthWeights(idx);
+    }
+    bool spansReady() const { return utils::storage_traits<_StProv>::spansReady(inner); }
+    auto rowWords(const index_type& idx) const
+    requires requires(const _StProv& s) { s.rowWords(idx); } {
+        return inner.rowWords(idx);
+    }
+
+    /**
+     * 两个结点是否（弱）连通，结点不存在时返回 false
+     */
+    bool connected(const index_type& a, const index_type& b) const {
+        if (stale) rebuild();
+        return sets.connected(a, b);
+    }
+
+    /**
+     * 结点所在分量的代表元，结点不存在时返回 max()
+     */
+    index_type component(const index_type& idx) const {
+        if (stale) rebuild();
+        return sets.find(idx);
+    }
+
+    size_t countComponents() const {
+        if (stale) rebuild();
+        return sets.count();
+    }
+};
+
+namespace utils {
+
+template<class _StProv>
+struct scans_back_range<ComponentStorage<_StProv>>: scans_back_range<_StProv> { };
+
+// rows are rebuilt in place, safe only because snapshots copy the weights
+template<class _IdxTp, class _WhtTp, bool _Directed, bool _EnableBackIndex>
+struct shard_local_edges<
+    FlatHashStorage<_IdxTp, _WhtTp, _Directed, _EnableBackIndex>
+>: std::true_type { };
+
+template<class _IdxTp, class _WhtTp>
+struct scans_back_range<FlatHashStorage<_IdxTp, _WhtTp, true, false>>: std::true_type { };
+
+template<class _IdxTp, class _WhtTp, bool _EnableBackIndex>
+struct local_back_range<
+    FlatHashStorage<_IdxTp, _WhtTp, false, _EnableBackIndex>
+>: std::true_type { };
+
+template<class _IdxTp, class _WhtTp, bool _Directed>
+struct shard_local_edges<MatrixStorage<_IdxTp, _WhtTp, _Directed>>: std::true_type { };
+
+template<class _IdxTp, class _WhtTp, bool _Directed>
+struct shard_local_edges<FlatMatrixStorage<_IdxTp, _WhtTp, _Directed>>: std::true_type { };
+
+template<class _IdxTp, bool _Directed>
+struct shard_local_edges<BitMatrixStorage<_IdxTp, _Directed>>: std::true_type { };
+
+}
+// namespace dsl::graph::utils
+
+/**
+ * 并发读写的存储包装器
+ * 按结点下标把结点分到 _Shards 个读写锁分片上：
+ * -# 读邻接（getForth / forthRange / getWeight 等）只共享锁住该结点的分片，
+ *    读者之间互不阻塞，也只在写者正在改动同一分片时等待一次边操作；
+ * -# 写边时独占两个端点的分片，写者之间另由一把互斥锁串行
+ *    （被包装的存储会更新共享的边计数）；
+ *    shard_local_edges 为假的存储写边时独占全部分片；
+ * -# 增删结点、sync、bulkLoad 独占全部分片。
+ * forthRange / backRange 在锁内把邻接点连同权值复制成快照，遍历时不持有锁，
+ * 快照中的权重指针指向快照自己的副本，写入它们不会修改图。
+ * getWeight 按值返回；getForth / getBack 给出的权重指针仍指向被包装的存储，
+ * 只在没有写者改动该结点的邻接时有效，并发写入时请改用 forthRange / backRange。
+ * size() 读取写者维护的原子计数，不等待写者。expose() 与 base() 不加锁。
+ * SimpleGraph 在增删结点时通过 lockNodes() 串行化整个过程。
+ * 全部分片同时加锁时持有 _Shards 把锁，ThreadSanitizer 的死锁检测最多跟踪 64 把，
+ * 因此默认使用 32 个分片。
+ */
+template<class _StProv, size_t _Shards = 32>
+class ConcurrentStorage {
+public:
+    typedef typename _StProv::index_type index_type;
+    typedef typename _StProv::weight_type weight_type;
+    typedef typename _StProv::storage_type storage_type;
+    typedef typename _StProv::null_weight null_weight;
+
+    static constexpr weight_type fallback = _StProv::fallback;
+
+private:
+    static_assert(
+        std::is_integral_v<index_type>,
+        "ConcurrentStorage: index type should be integral"
+    );
+    typedef ConcurrentStorage<_StProv, _Shards> self;
+    typedef utils::ShardedMutex<_Shards> mutex_type;
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef std::vector<std::pair<index_type, weight_type>> snapshot_type;
+    static constexpr bool local_edges = utils::shard_local_edges<_StProv>::value;
+    static constexpr bool local_back = utils::local_back_range<_StProv>::value;
+    static constexpr bool sized = requires(const _StProv& s) { s.size(); };
+
+    _StProv inner;
+    mutable mutex_type locks;
+    mutable std::mutex writer;
+    std::mutex nodes;
+    std::atomic<size_t> edge_total;
+
+    static size_t key(const index_type& idx) { return static_cast<size_t>(idx); }
+
+    // called with every shard the last write touched still held
+    void publish_size() {
+        if constexpr (sized) edge_total.store(inner.size(), std::memory_order_release);
+    }
+
+    // runs fn while writing the edge (from, to)
+    template<class _Fn>
+    void write_edge(const index_type& from, const index_type& to, _Fn&& fn) {
+        if constexpr (local_edges) {
+            std::lock_guard<std::mutex> guard(writer);
+            typename mutex_type::pair_guard hold(locks, key(from), key(to));
+            fn();
+            publish_size();
+        } else {
+            typename mutex_type::all_guard hold(locks);
+            fn();
+            publish_size();
+        }
+    }
+
+    template<class _Fn>
+    void write_all(_Fn&& fn) {
+        typename mutex_type::all_guard hold(locks);
+        fn();
+        publish_size();
+    }
+
+    // copies (index, weight) pairs of a range while its shard is held
+    template<class _Range>
+    static std::shared_ptr<snapshot_type> copy_range(const _Range& range) {
+        auto items = std::make_shared<snapshot_type>();
+        for (auto [v, wp]: range) items->emplace_back(v, *wp);
+        return items;
+    }
+
+    // snapshot of the adjacency handed out by forthRange / backRange, owning its weights
+    struct snapshot_cursor {
+        typedef typename _StProv::index_type index_type;
+        typedef typename _StProv::weight_type weight_type;
+        std::shared_ptr<snapshot_type> items;
+        size_t pos = 0;
+
+        bool done() const { return items == nullptr || pos >= items->size(); }
+        void next() { ++pos; }
+        index_type index() const { return (*items)[pos].first; }
+        weight_type* weight() const { return &(*items)[pos].second; }
+    };
+
+    // copies out of cs first, so the two sets of shards are never held together
+    static _StProv copy_of(const self& cs) {
+        typename mutex_type::shared_all_guard hold(cs.locks);
+        return cs.inner;
+    }
+
+public:
+    ConcurrentStorage(): inner(), locks(), writer(), nodes(), edge_total(0) { }
+    ConcurrentStorage(const self& cs):
+        inner(copy_of(cs)), locks(), writer(), nodes(), edge_total(0)
+    {
+        publish_size();
+    }
+    self& operator=(const self& cs) {
+        if (this == &cs) return *this;
+        _StProv copy = copy_of(cs);
+        write_all([&] { inner = std::move(copy); });
+        return *this;
+    }
+
+    /**
+     * 被包装的存储，不加锁
+     */
+    _StProv& base() { return inner; }
+    const _StProv& base() const { return inner; }
+
+    /**
+     * 增删结点期间持有的锁，由 SimpleGraph 调用
+     */
+    std::unique_lock<std::mutex> lockNodes() { return std::unique_lock<std::mutex>(nodes); }
+
+    /**
+     * 最近一次写入完成时的边数，不加锁
+     */
+    size_t size() const requires sized {
+        return edge_total.load(std::memory_order_acquire);
+    }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return inner.expose(); }
+
+    /**
+     * [StorageProvider.sync]
+     */
+    void sync(size_t v_size) { write_all([&] { inner.sync(v_size); }); }
+
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(const index_type& idx) { write_all([&] { inner.addIndex(idx); }); }
+
+    /**
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(const index_type& idx) {
+        index_type ret;
+        write_all([&] { ret = inner.removeIndex(idx); });
+        return ret;
+    }
+
+    /**
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(const index_type& from, const index_type& to, const weight_type& weight) {
+        write_edge(from, to, [&] { inner.addEdge(from, to, weight); });
+    }
+
+    void bulkLoad(const std::vector<std::tuple<index_type, index_type, weight_type>>& edges) {
+        write_all([&] {
+            if constexpr (requires { inner.bulkLoad(edges); }) {
+                inner.bulkLoad(edges);
+            } else {
+                for (auto& [from, to, weight]: edges) inner.addEdge(from, to, weight);
+            }
+        });
+    }
+
+    /**
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(const index_type& from, const index_type& to) {
+        write_edge(from, to, [&] { inner.removeEdge(from, to); });
+    }
+
+    /**
+     * 在锁内复制出边权
+     * [StorageProvider.getWeight]
+     */
+    weight_type getWeight(const index_type& from, const index_type& to) const {
+        std::shared_lock<std::shared_mutex> shard(locks.shard(locks.shardOf(key(from))));
+        return inner.getWeight(from, to);
+    }
+
+    /**
+     * 同 getWeight
+     */
+    weight_type loadWeight(const index_type& from, const index_type& to) const {
+        return getWeight(from, to);
+    }
+
+    /**
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(const index_type& from, const index_type& to, const weight_type& weight) {
+        write_edge(from, to, [&] { inner.setWeight(from, to, weight); });
+    }
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(const index_type& idx, contain_type& contain) const {
+        std::shared_lock<std::shared_mutex> shard(locks.shard(locks.shardOf(key(idx))));
+        inner.getForth(idx, contain);
+    }
+
+    /**
+     * [StorageProvider.getBack]
+     */
+    void getBack(const index_type& idx, contain_type& contain) const {
+        if constexpr (local_back) {
+            std::shared_lock<std::shared_mutex> shard(locks.shard(locks.shardOf(key(idx))));
+            inner.getBack(idx, contain);
+        } else {
+            typename mutex_type::shared_all_guard hold(locks);
+            inner.getBack(idx, contain);
+        }
+    }
+
+    utils::AdjacentRange<snapshot_cursor> forthRange(const index_type& idx) const {
+        std::shared_lock<std::shared_mutex> shard(locks.shard(locks.shardOf(key(idx))));
+        return utils::AdjacentRange<snapshot_cursor>(
+            snapshot_cursor{copy_range(inner.forthRange(idx)), 0}
+        );
+    }
+
+    utils::AdjacentRange<snapshot_cursor> backRange(const index_type& idx) const {
+        if constexpr (local_back) {
+            std::shared_lock<std::shared_mutex> shard(locks.shard(locks.shardOf(key(idx))));
+            return utils::AdjacentRange<snapshot_cursor>(
+                snapshot_cursor{copy_range(inner.backRange(idx)), 0}
+            );
+        } else {
+            typename mutex_type::shared_all_guard hold(locks);
+            return utils::AdjacentRange<snapshot_cursor>(
+                snapshot_cursor{copy_range(inner.backRange(idx)), 0}
+            );
+        }
+    }
+};
+
+/**
+ * 并发读写的下标提供器包装器
+ * 查找与取值只共享锁住当前线程所属的分片，插入与删除独占全部分片。
+ * at() 返回的引用在锁外使用，只在被包装的提供器不移动结点值时
+ * （如 DefaultIndexProvider）于结点被删除前保持有效。
+ */
+template<class _IdxProv, size_t _Shards = 16>
+class ConcurrentIndexProvider {
+public:
+    typedef typename _IdxProv::value_type value_type;
+    typedef typename _IdxProv::index_type index_type;
+    typedef typename _IdxProv::key_type key_type;
+
+private:
+    typedef ConcurrentIndexProvider<_IdxProv, _Shards> self;
+
+    _IdxProv inner;
+    mutable utils::ShardedMutex<_Shards> locks;
+
+    template<class _Fn>
+    decltype(auto) read(_Fn&& fn) const {
+        std::shared_lock<std::shared_mutex> shard(locks.shard(locks.threadShard()));
+        return fn();
+    }
+
+    template<class _Fn>
+    decltype(auto) write(_Fn&& fn) {
+        typename utils::ShardedMutex<_Shards>::all_guard guard(locks);
+        return fn();
+    }
+
+public:
+    ConcurrentIndexProvider(): inner(), locks() { }
+
+    _IdxProv& base() { return inner; }
+    const _IdxProv& base() const { return inner; }
+
+    index_type insert(const value_type& node) { return write([&] { return inner.insert(node); }); }
+
+    template<class... Args>
+    index_type emplace(Args&&... args) {
+        return write([&] { return inner.emplace(std::forward<Args>(args)...); });
+    }
+
+    void remove(index_type index) { write([&] { inner.remove(index); }); }
+    void rewind(index_type index) { write([&] { inner.rewind(index); }); }
+
+    void relocate(index_type from, index_type to)
+    requires requires(_IdxProv& p) { p.relocate(from, to); } {
+        write([&] { inner.relocate(from, to); });
+    }
+
+    size_t size() const { return read([&] { return inner.size(); }); }
+    index_type available() const { return read([&] { return inner.available(); }); }
+    index_type find(const key_type& key) const { return read([&] { return inner.find(key); }); }
+
+    std::vector<index_type> findAll(const key_type& key) const {
+        return read([&] { return inner.findAll(key); });
+    }
+
+    void allIndexes(std::vector<index_type>& contain) const {
+        read([&] { inner.allIndexes(contain); });
+    }
+
+    const value_type& at(index_type index) const {
+        return read([&]() -> const value_type& { return inner.at(index); });
+    }
+    value_type& at(index_type index) {
+        return read([&]() -> value_type& { return inner.at(index); });
+    }
+
+    /**
+     * 在锁内复制出结点值
+     */
+    value_type load(index_type index) const {
+        return read([&] { return value_type(inner.at(index)); });
+    }
+};
+
+/*!
+ * @brief 
+ * @tparam _ValTp 
+ * @tparam _WhtTp 
+ * @tparam _Directed 
+ * @tparam _IdxTp 
+ * @tparam _StProv 
+ * @tparam _IdxProv 
+ */
+template<
+    DSL_MACRO_VALUE_TYPE _ValTp,
+    DSL_MACRO_WEIGHT_TYPE _WhtTp,
+    bool _Directed,
+    DSL_MACRO_INDEX_TYPE _IdxTp = size_t,
+    DSL_MACRO_STORE_PROVIDER _StProv = HashListStorage<_IdxTp, _WhtTp, _Directed>,
+    DSL_MACRO_INDEX_PROVIDER _IdxProv = DefaultIndexProvider<_ValTp, _IdxTp>
+>
+class SimpleGraph {
+public:
+    typedef _ValTp value_type;
+    typedef _IdxTp index_type;
+    typedef _WhtTp weight_type;
+    typedef utils::null_weight<weight_type> null_weight;
+    typedef utils::index_limits<index_type> idx_limit;
+    typedef _IdxProv::key_type key_type;
+    typedef std::tuple<index_type, index_type, weight_type> edge_type;
+
+    static constexpr index_type nindex = idx_limit::max();
+    static constexpr weight_type nweight = _StProv::fallback;
+
+private:
+    typedef _IdxProv index_prov_t;
+    typedef _StProv store_prov_t;
+    typedef
+    SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>
+    self;
+
+#ifdef DSL_DEBUG
+public:
+#else
+private:
+#endif
+    index_prov_t index_provider;
+    store_prov_t storage_provider;
+
+private:
+    typedef std::chrono::steady_clock clock_type;
+
+    static double seconds_since(clock_type::time_point start) {
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    // sort, deduplicate (last one wins) and hand edges to the storage provider
+    void ingest(
+        std::vector<edge_type>& edges,
+        size_t thread_count,
+        utils::IngestStats& stats
+    ) {
+        auto start = clock_type::now();
+        for (auto& [from, to, weight]: edges) {
+            if constexpr (!_Directed) {
+                if (to < from) std::swap(from, to);
+            }
+            if constexpr (std::is_same_v<weight_type, bool>) weight = true;
+        }
+        general::utils::ThreadPool pool(thread_count);
+        general::utils::parallel_sort(
+            edges.begin(), edges.end(),
+            [](const edge_type& l, const edge_type& r) {
+                if (std::get<0>(l) != std::get<0>(r)) {
+                    return std::get<0>(l) < std::get<0>(r);
+                }
+                return std::get<1>(l) < std::get<1>(r);
+            },
+            pool
+        );
+        size_t kept = 0;
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (
+                i + 1 < edges.size() &&
+                std::get<0>(edges[i]) == std::get<0>(edges[i + 1]) &&
+                std::get<1>(edges[i]) == std::get<1>(edges[i + 1])
+            ) continue;
+            if (kept != i) edges[kept] = std::move(edges[i]);
+            ++kept;
+        }
+        edges.resize(kept);
+        stats.loaded = kept;
+        stats.sort_seconds += seconds_since(start);
+
+        start = clock_type::now();
+        if constexpr (requires { storage_provider.bulkLoad(edges); }) {
+            storage_provider.bulkLoad(edges);
+        } else {
+            for (auto& [from, to, weight]: edges) {
+                storage_provider.addEdge(from, to, weight);
+            }
+        }
+        stats.build_seconds += seconds_since(start);
+    }
+
+    // held while a vertex is added or removed, if the storage asks for it
+    auto node_guard() {
+        if constexpr (requires { storage_provider.lockNodes(); }) {
+            return storage_provider.lockNodes();
+        } else {
+            return 0;
+        }
+    }
+
+    void copy_from(const self& g) {
+        index_provider = g.index_provider;
+        storage_provider = g.storage_provider;
+    }
+    void move_from(self& g) {
+        index_provider = std::move(g.index_provider);
+        storage_provider = std::move(g.storage_provider);
+    }
+
+public:
+    typedef accessors::GraphAccessor<
+        value_type, index_type, weight_type,
+        index_prov_t, store_prov_t
+    > accessor;
+
+    typedef accessors::GraphAccessor<
+        const value_type, index_type, weight_type,
+        const index_prov_t, const store_prov_t
+    > const_accessor;
+
+    SimpleGraph(){  };
+    SimpleGraph(const self& g) { copy_from(g); }
+    SimpleGraph(self&& rg) { move_from(rg); }
+    self& operator= (const self& g) { copy_from(g); return *this; }
+    self& operator= (self&& rg) { move_from(rg); return *this; }
+
+    std::vector<index_type> findIndexes(
+        const key_type& key, size_t count = 1
+    ) const {
+        return index_provider.findAll(key);
+    }
+
+    index_type find(
+        const key_type& key
+    ) const {
+        return index_provider.find(key);
+    }
+
+    std::vector<index_type> allIndexes() const {
+        std::vector<index_type> result;
+        index_provider.allIndexes(result);
+        return result;
+    }
+
+    const value_type& nodeAt(const index_type& index) const {
+        return index_provider.at(index);
+    }
+    value_type& nodeAt(const index_type& index) {
+        return index_provider.at(index);
+    }
+
+    index_type addNode(const value_type& val) {
+        [[maybe_unused]] auto guard = node_guard();
+        storage_provider.sync(index_provider.size() + 1);
+        index_type idx = index_provider.insert(val);
+        storage_provider.addIndex(idx);
+        return idx;
+    }
+    template<class... Args>
+    index_type emplaceNode(Args&&... args) {
+        [[maybe_unused]] auto guard = node_guard();
+        storage_provider.sync(index_provider.size() + 1);
+        index_type idx = index_provider.emplace(std::forward<Args>(args)...);
+        storage_provider.addIndex(idx);
+        return idx;
+    }
+    index_type removeNode(const index_type& idx) {
+        [[maybe_unused]] auto guard = node_guard();
+        const index_type& ret = storage_provider.removeIndex(idx);
+        if (ret != idx_limit::max()) {
+            if constexpr (requires { index_provider.relocate(ret, idx); }) {
+                index_provider.relocate(ret, idx);
+            } else {
+                index_provider.at(idx) = index_provider.at(ret);
+                index_provider.remove(ret);
+                index_provider.rewind(ret);
+            }
+        } else {
+            index_provider.remove(idx);
+        }
+        storage_provider.sync(index_provider.size());
+        return ret;
+    }
+
+    /**
+     * 返回底层存储的引用，用于调用存储特有的接口
+     * （如 CsrStorage::freeze）
+     */
+    store_prov_t& storage() { return storage_provider; }
+    const store_prov_t& storage() const { return storage_provider; }
+
+    /**
+     * 返回下标提供器的引用，用于调用提供器特有的接口
+     */
+    index_prov_t& indexProvider() { return index_provider; }
+    const index_prov_t& indexProvider() const { return index_provider; }
+
+    size_t countVertex() const { return index_provider.size(); }
+    size_t countEdge() const { return storage_provider.size(); }
+
+    self& addEdge(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight = null_weight::value()
+    ) {
+        if constexpr (std::is_same_v<weight_type, bool>) {
+            storage_provider.addEdge(from, to, true);
+        } else {
+            storage_provider.addEdge(from, to, weight);
+        }
+        return *this;
+    }
+    self& addEdgeByKey(
+        const key_type& key_from,
+        const key_type& key_to,
+        const weight_type& weight = null_weight::value()
+    ) {
+        index_type from = index_provider.find(key_from), to = index_provider.find(key_to);
+        if (from == nindex || to == nindex) return *this;
+        return addEdge(from, to, weight);
+    }
+
+    /**
+     * 批量加载边
+     * 边先被并行排序并去重（重复的边保留最后一次出现的权重），
+     * 再交给存储提供器一次性建立邻接结构；
+     * 提供器没有 bulkLoad 时逐条调用 addEdge。
+     * @param edges (from, to, weight) 三元组
+     * @param thread_count 排序使用的线程数，0 表示使用硬件并发数
+     * @return 各阶段的耗时与吞吐量
+     */
+    utils::IngestStats bulkLoad(
+        std::span<const edge_type> edges,
+        size_t thread_count = 0
+    ) requires std::totally_ordered<index_type> {
+        utils::IngestStats stats;
+        stats.read = edges.size();
+        std::vector<edge_type> buffer(edges.begin(), edges.end());
+        ingest(buffer, thread_count, stats);
+        return stats;
+    }
+
+    /**
+     * 从文本边表流式加载边
+     * 每行为 "from to [weight]"，from 与 to 为结点的键，
+     * 缺省权重为 1；空行以及以 '#' 或 '%' 开头的行被跳过，
+     * 权重无法解析的行计入 skipped。
+     * 键不存在时若值类型可由键构造则新建结点，否则跳过该边。
+     */
+    utils::IngestStats bulkLoad(
+        std::istream& input,
+        size_t thread_count = 0
+    ) requires std::totally_ordered<index_type> && requires(
+        std::istream& is, key_type& key, weight_type& weight
+    ) { is >> key; is >> weight; } {
+        utils::IngestStats stats;
+        auto start = clock_type::now();
+        auto resolve = [this](const key_type& key) {
+            index_type idx = index_provider.find(key);
+            if constexpr (std::is_constructible_v<value_type, const key_type&>) {
+                if (idx == idx_limit::max()) idx = addNode(value_type(key));
+            }
+            return idx;
+        };
+
+        std::vector<edge_type> buffer;
+        std::string line;
+        std::istringstream parser;
+        key_type from, to;
+        weight_type weight;
+        while (std::getline(input, line)) {
+            size_t head = line.find_first_not_of(" \t\r");
+            if (head == std::string::npos || line[head] == '#' || line[head] == '%') {
+                continue;
+            }
+            ++stats.read;
+            parser.clear();
+            parser.str(line);
+            if (!(parser >> from >> to)) { ++stats.skipped; continue; }
+            if (!(parser >> weight)) {
+                // only a missing weight falls back to the default, a malformed one skips the line
+                if (!parser.eof()) { ++stats.skipped; continue; }
+                if constexpr (std::is_arithmetic_v<weight_type>) weight = 1;
+                else weight = null_weight::value();
+            }
+            index_type idx_from = resolve(from), idx_to = resolve(to);
+            if (idx_from == idx_limit::max() || idx_to == idx_limit::max()) {
+                ++stats.skipped;
+                continue;
+            }
+            buffer.emplace_back(idx_from, idx_to, weight);
+        }
+        stats.parse_seconds = seconds_since(start);
+        ingest(buffer, thread_count, stats);
+        return stats;
+    }
+
+    self& removeEdge(
+        const index_type& from,
+        const index_type& to
+    ) {
+        storage_provider.removeEdge(from, to);
+        return *this;
+    }
+    self& removeEdgeByKey(
+        const key_type& key_from,
+        const key_type& key_to
+    ) {
+        index_type from = index_provider.find(key_from), to = index_provider.find(key_to);
+        if (from != nindex && to != nindex) storage_provider.removeEdge(from, to);
+        return *this;
+    }
+
+    utils::weight_result_t<_StProv> getWeight(
+        const index_type& from,
+        const index_type& to
+    ) const {
+        return storage_provider.getWeight(from, to);
+    }
+    utils::weight_result_t<_StProv> getWeightByKey(
+        const key_type& key_from,
+        const key_type& key_to
+    ) const {
+        index_type from = index_provider.find(key_from), to = index_provider.find(key_to);
+        if (from == nindex || to == nindex) return _StProv::fallback;
+        return storage_provider.getWeight(from, to);
+    }
+
+    void setWeight(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        storage_provider.setWeight(from, to, weight);
+    }
+    void setWeightByKey(
+        const key_type& key_from,
+        const key_type& key_to,
+        const weight_type& weight
+    ) {
+        index_type from = index_provider.find(key_from), to = index_provider.find(key_to);
+        if (from != nindex && to != nindex) storage_provider.setWeight(from, to, weight);
+    }
+
+    value_type& operator[] (const index_type& index) {
+        return index_provider.at(index);
+    }
+    const value_type& operator[] (const index_type& index) const {
+        return index_provider.at(index);
+    }
+
+    accessor access() {
+        index_type idx = index_provider.available();
+        if (idx != idx_limit::max()) {
+            return accessor(
+                &index_provider,
+                &storage_provider,
+                idx
+            );
+        } else {
+            return accessor(
+                nullptr,
+                nullptr,
+                idx
+            );
+        }
+    }
+    accessor access(const index_type& init_idx) {
+        if (init_idx != idx_limit::max()) {
+            return accessor(
+                &index_provider,
+                &storage_provider,
+                init_idx
+            );
+        } else {
+            return accessor(
+                nullptr,
+                nullptr,
+                init_idx
+            );
+        }
+    }
+
+    const_accessor const_access() const {
+        index_type idx = index_provider.available();
+        if (idx != idx_limit::max()) {
+            return const_accessor(
+                &index_provider,
+                &storage_provider,
+                idx
+            );
+        } else {
+            return const_accessor(
+                nullptr,
+                nullptr,
+                idx
+            );
+        }
+    }
+    const_accessor const_access(const index_type& init_idx) const {
+        if (init_idx != idx_limit::max()) {
+            return const_accessor(
+                &index_provider,
+                &storage_provider,
+                init_idx
+            );
+        } else {
+            return const_accessor(
+                nullptr,
+                nullptr,
+                init_idx
+            );
+        }
+    }
+
+};
+
+namespace algorithms {
+
+namespace detail {
+
+/**
+ * 对 u 的每条出边调用 fn(v, weight)
+ * 存储提供连续的出边数组时直接遍历数组，否则使用 forthRange。
+ */
+template<class _StProv, class _Fn>
+inline void for_each_forth(
+    const _StProv& storage,
+    const typename _StProv::index_type& u,
+    _Fn&& fn
+) {
+    typedef utils::storage_traits<_StProv> traits;
+    if constexpr (traits::contiguous) {
+        if (traits::spansReady(storage)) {
+            auto ids = storage.forthSpan(u);
+            auto weights = storage.forthWeights(u);
+            for (size_t i = 0; i < ids.size(); ++i) fn(ids[i], weights[i]);
+            return ;
+        }
+    }
+    for (auto [v, wp]: storage.forthRange(u)) fn(v, *wp);
+}
+
+}
+// namespace dsl::graph::algorithms::detail
+
+/**
+ * 广度优先遍历，on_node 返回 false 时立即结束
+ * on_node 可以是任意可调用对象，以结点值的引用调用。
+ * 扫描出边的方式按存储的能力（utils::storage_traits）在编译期选择：
+ * 位矩阵按字与访问位图求差，连续存储直接遍历数组，其余使用 forthRange；
+ * 整数下标的访问标记为位图。
+ */
+template<
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv, class _Visit
+>
+void BFS(
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
+    >& accessor,
+    _Visit&& on_node
+) {
+    typedef accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
+    > __accessor;
+    typedef utils::storage_traits<std::remove_cv_t<_StProv>> traits;
+    if (accessor.invalid()) return ;
+    const auto& storage = accessor.storage();
+    utils::VisitSet<_IdxTp> visited;
+    std::vector<_IdxTp> queue;
+    __accessor acc = accessor;
+    queue.push_back(accessor.raw());
+    visited.insert(accessor.raw());
+    for (size_t head = 0; head < queue.size(); ++head) {
+        _IdxTp u = queue[head];
+        acc.move(u);
+        if (!on_node(*acc)) return ;
+        if constexpr (traits::bit_rows && traits::dense) {
+            auto row = storage.rowWords(u);
+            uint64_t* seen = visited.words(row.size());
+            for (size_t w = 0; w < row.size(); ++w) {
+                uint64_t fresh = row[w] & ~seen[w];
+                seen[w] |= fresh;
+                for (; fresh != 0; fresh &= fresh - 1) {
+                    queue.push_back(static_cast<_IdxTp>((w << 6) + std::countr_zero(fresh)));
+                }
+            }
+        } else {
+            detail::for_each_forth(storage, u, [&](const _IdxTp& v, const auto&) {
+                if (visited.insert(v)) queue.push_back(v);
+            });
+        }
+    }
+}
+
+/**
+ * 深度优先遍历，on_node 返回 false 时不再展开该结点
+ * 使用显式栈保存每层的邻接点游标，不会因路径过长而栈溢出。
+ * on_node 可以是任意可调用对象；整数下标的访问标记为位图。
+ * 存储提供连续的出边数组时（utils::storage_traits::contiguous）栈中保存数组与位置，
+ * 否则保存 forthRange 的游标。
+ */
+template<
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv, class _Visit
+>
+void DFS(
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
+    >& accessor,
+    _Visit&& on_node
+) {
+    typedef accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
+    > __accessor;
+    typedef utils::storage_traits<std::remove_cv_t<_StProv>> traits;
+    typedef decltype(accessor.forth().raw()) range_t;
+    typedef std::pair<_IdxTp, typename range_t::iterator> frame_t;
+    utils::VisitSet<_IdxTp> visited;
+    if (accessor.invalid()) return ;
+    __accessor acc = accessor;
+    visited.insert(accessor.raw());
+    if (!on_node(*acc)) return ;
+    if constexpr (traits::contiguous) {
+        const auto& storage = accessor.storage();
+        if (traits::spansReady(storage)) {
+            typedef decltype(storage.forthSpan(accessor.raw())) span_t;
+            std::vector<std::pair<span_t, size_t>> stack;
+            stack.emplace_back(storage.forthSpan(accessor.raw()), 0);
+            while (!stack.empty()) {
+                auto& [ids, pos] = stack.back();
+                if (pos == ids.size()) {
+                    stack.pop_back();
+                    continue;
+                }
+                _IdxTp idx = ids[pos++];
+                if (!visited.insert(idx)) continue;
+                acc.move(idx);
+                if (!on_node(*acc)) continue;
+                stack.emplace_back(storage.forthSpan(idx), 0);
+            }
+            return ;
+        }
+    }
+    std::vector<frame_t> stack;
+    stack.emplace_back(accessor.raw(), acc.forth().raw().begin());
+    while (!stack.empty()) {
+        auto& iter = stack.back().second;
+        if (iter == typename range_t::sentinel()) {
+            stack.pop_back();
+            continue;
+        }
+        _IdxTp idx = (*iter).first;
+        ++iter;
+        if (!visited.insert(idx)) continue;
+        acc.move(idx);
+        if (!on_node(*acc)) continue;
+        stack.emplace_back(idx, acc.forth().raw().begin());
+    }
+}
+
+namespace detail {
+
+// default non-tree edge callback of DepthFirst
+struct dfs_ignore_edge {
+    template<class _IdxTp>
+    void operator()(const _IdxTp&, const _IdxTp&) const { }
+};
+
+}
+// namespace dsl::graph::algorithms::detail
+
+/**
+ * 可复用的迭代式深度优先遍历
+ * 显式栈中保存 (结点, 出边游标)，visited 为以下标为位的稠密位图，
+ * 栈与位图在多次 run 之间保留内存；reset() 清空访问标记。
+ * 回调均为模板参数，不经过 std::function：
+ * -# pre(v) -> bool：首次访问 v 时调用，返回 false 时不展开 v 的出边；
+ * -# post(v, parent)：v 的出边全部处理完后调用，根的 parent 为 nindex；
+ * -# edge(u, v)：边 u -> v 的终点已被访问过（非树边）时调用。
+ * 要求下标为整数。
+ */
+template<class _StProv>
+class DepthFirst {
+public:
+    typedef typename _StProv::index_type index_type;
+    static constexpr index_type nindex = utils::index_limits<index_type>::max();
+
+private:
+    static_assert(
+        std::is_integral_v<index_type>,
+        "DepthFirst: index type should be integral"
+    );
+    typedef decltype(std::declval<const _StProv&>().forthRange(index_type())) range_t;
+    typedef typename range_t::iterator cursor_t;
+
+    struct frame {
+        index_type vertex;
+        cursor_t cursor;
+    };
+
+    const _StProv* storage;
+    std::vector<frame> stack;
+    std::vector<uint64_t> bits;
+
+    void mark(index_type v) {
+        size_t i = static_cast<size_t>(v);
+        if ((i >> 6) >= bits.size()) bits.resize(std::max((i >> 6) + 1, bits.size() * 2), 0);
+        bits[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+public:
+    explicit DepthFirst(const _StProv& st): storage(&st), stack(), bits() { }
+
+    bool visited(index_type v) const {
+        size_t i = static_cast<size_t>(v);
+        return (i >> 6) < bits.size() && ((bits[i >> 6] >> (i & 63)) & 1);
+    }
+
+    void reset() { std::fill(bits.begin(), bits.end(), 0); }
+
+    /**
+     * 从 root 开始遍历，root 已被访问时直接返回；访问标记在两次 run 之间保留
+     */
+    template<class _Pre, class _Post, class _Edge = detail::dfs_ignore_edge>
+    void run(index_type root, _Pre&& pre, _Post&& post, _Edge&& edge = _Edge()) {
+        if (visited(root)) return ;
+        mark(root);
+        if (!pre(root)) {
+            post(root, nindex);
+            return ;
+        }
+        stack.clear();
+        stack.push_back(frame{root, storage->forthRange(root).begin()});
+        while (!stack.empty()) {
+            frame& top = stack.back();
+            if (top.cursor == typename range_t::sentinel()) {
+                index_type v = top.vertex;
+                stack.pop_back();
+                post(v, stack.empty() ? nindex : stack.back().vertex);
+                continue;
+            }
+            index_type u = top.vertex;
+            index_type v = (*top.cursor).first;
+            ++top.cursor;
+            if (visited(v)) {
+                edge(u, v);
+                continue;
+            }
+            mark(v);
+            if (!pre(v)) {
+                post(v, u);
+                continue;
+            }
+            stack.push_back(frame{v, storage->forthRange(v).begin()});
+        }
+    }
+};
+
+/**
+ * 单源最短路的结果
+ * distance / previous 以稠密的结点下标为索引，
+ * 未到达的结点距离为 unreachable，前驱为 nindex。
+ */
+template<class _IdxTp, class _DistTp>
+struct ShortestPaths {
+    typedef _IdxTp index_type;
+    typedef _DistTp distance_type;
+
+    static constexpr index_type nindex = utils::index_limits<index_type>::max();
+    static constexpr distance_type unreachable =
+        std::numeric_limits<distance_type>::max();
+
+    index_type source;
+    std::vector<distance_type> distance;
+    std::vector<index_type> previous;
+
+    ShortestPaths(): source(nindex), distance(), previous() { }
+
+    // grow arrays so that idx is addressable
+    inline void touch(const index_type& idx) {
+        size_t need = static_cast<size_t>(idx) + 1;
+        if (need <= distance.size()) return ;
+        need = std::max(need, distance.size() * 2);
+        distance.resize(need, unreachable);
+        previous.resize(need, nindex);
+    }
+
+    bool reached(const index_type& idx) const {
+        size_t i = static_cast<size_t>(idx);
+        return i < distance.size() && distance[i] != unreachable;
+    }
+
+    /**
+     * 返回从源点到 idx 的路径（含两端），不可达时返回空列表
+     */
+    std::vector<index_type> pathTo(const index_type& idx) const {
+        std::vector<index_type> path;
+        if (!reached(idx)) return path;
+        for (index_type i = idx; i != nindex; i = previous[i]) {
+            path.push_back(i);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+/**
+ * 单源最短路（Dijkstra），使用支持 decrease-key 的 d 叉堆
+ * 要求边权非负，下标为稠密整数
+ * @tparam _Arity 堆的分叉数
+ */
+template<
+    size_t _Arity = 4,
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+ShortestPaths<_IdxTp, _WhtTp> Dijkstra(
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& accessor
+) {
+    static_assert(
+        std::is_arithmetic_v<_WhtTp> && !std::is_same_v<_WhtTp, bool>,
+        "Dijkstra: weight type should be arithmetic"
+    );
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "Dijkstra: index type should be integral"
+    );
+    ShortestPaths<_IdxTp, _WhtTp> result;
+    if (accessor.invalid()) return result;
+
+    utils::DaryHeap<_Arity, _IdxTp, _WhtTp> heap;
+    const auto& storage = accessor.storage();
+    result.source = accessor.raw();
+    result.touch(result.source);
+    result.distance[result.source] = _WhtTp();
+    heap.push(result.source, _WhtTp());
+    while (!heap.empty()) {
+        auto [dist, idx] = heap.pop();
+        detail::for_each_forth(storage, idx, [&](const _IdxTp& next, const _WhtTp& weight) {
+            _WhtTp relaxed = dist + weight;
+            result.touch(next);
+            if (relaxed < result.distance[next]) {
+                result.distance[next] = relaxed;
+                result.previous[next] = idx;
+                heap.update(next, relaxed);
+            }
+        });
+    }
+    return result;
+}
+
+/**
+ * 单源最短路（Dijkstra），使用基数堆
+ * 仅适用于非负整数边权，距离不应超过 uint64_t 的范围
+ */
+template<
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+ShortestPaths<_IdxTp, _WhtTp> RadixDijkstra(
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& accessor
+) {
+    static_assert(
+        std::is_integral_v<_WhtTp> && !std::is_same_v<_WhtTp, bool>,
+        "RadixDijkstra: weight type should be integral"
+    );
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "RadixDijkstra: index type should be integral"
+    );
+    ShortestPaths<_IdxTp, _WhtTp> result;
+    if (accessor.invalid()) return result;
+
+    utils::RadixHeap<_IdxTp> heap;
+    const auto& storage = accessor.storage();
+    result.source = accessor.raw();
+    result.touch(result.source);
+    result.distance[result.source] = _WhtTp();
+    heap.push(result.source, 0);
+    while (!heap.empty()) {
+        auto [dist, idx] = heap.pop();
+        // skip stale entries left behind by later relaxations
+        if (dist != static_cast<uint64_t>(result.distance[idx])) continue;
+        detail::for_each_forth(storage, idx, [&](const _IdxTp& next, const _WhtTp& weight) {
+            _WhtTp relaxed = result.distance[idx] + weight;
+            result.touch(next);
+            if (relaxed < result.distance[next]) {
+                result.distance[next] = relaxed;
+                result.previous[next] = idx;
+                heap.push(next, static_cast<uint64_t>(relaxed));
+            }
+        });
+    }
+    return result;
+}
+
+/**
+ * 多源最短路的结果，按行主序连续存放
+ * 行宽 stride 为对齐到分块大小后的结点数，
+ * 不可达的结点对距离为 unreachable。
+ */
+template<class _DistTp>
+struct DistanceMatrix {
+    typedef _DistTp distance_type;
+
+    // half of max for integers so that unreachable + unreachable never overflows
+    static constexpr distance_type unreachable =
+        std::numeric_limits<distance_type>::has_infinity ?
+        std::numeric_limits<distance_type>::infinity() :
+        std::numeric_limits<distance_type>::max() / 2;
+
+    size_t size, stride;
+    std::vector<distance_type> data;
+
+    DistanceMatrix(): size(0), stride(0), data() { }
+
+    distance_type* row(size_t i) { return data.data() + i * stride; }
+    const distance_type* row(size_t i) const { return data.data() + i * stride; }
+
+    const distance_type& at(size_t from, size_t to) const {
+        return data[from * stride + to];
+    }
+
+    bool reached(size_t from, size_t to) const {
+        return at(from, to) != unreachable;
+    }
+};
+
+namespace detail {
+
+/**
+ * Min-plus update of tile c with tiles a and b:
+ * c[i][j] = min(c[i][j], a[i][k] + b[k][j])
+ * k stays outermost so tiles that alias each other are still correct.
+ * Rows of different tiles never overlap partially, hence ivdep.
+ */
+template<class _DistTp>
+void floyd_tile(
+    _DistTp* c, const _DistTp* a, const _DistTp* b,
+    size_t stride, size_t block
+) {
+    constexpr _DistTp inf = DistanceMatrix<_DistTp>::unreachable;
+    for (size_t k = 0; k < block; ++k) {
+        const _DistTp* bk = b + k * stride;
+        for (size_t i = 0; i < block; ++i) {
+            const _DistTp aik = a[i * stride + k];
+            if (!(aik < inf)) continue;
+            _DistTp* ci = c + i * stride;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#endif
+            for (size_t j = 0; j < block; ++j) {
+                _DistTp via = aik + bk[j];
+                ci[j] = via < ci[j] ? via : ci[j];
+            }
+        }
+    }
+}
+
+}
+// namespace dsl::graph::algorithms::detail
+
+/**
+ * 多源最短路（分块 Floyd–Warshall）
+ * 将图复制为行主序的连续矩阵后按 _Block × _Block 分块计算，
+ * 每轮中相互独立的块在线程池上并行执行。
+ * 要求下标为整数，且不存在负环；
+ * 整数权值的最短距离应小于 unreachable / 2。
+ * @tparam _Block 分块边长
+ * @param thread_count 线程数，0 表示使用硬件并发数
+ */
+template<
+    size_t _Block = 64,
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+DistanceMatrix<_WhtTp> Floyd(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    size_t thread_count = 0
+) {
+    static_assert(
+        std::is_arithmetic_v<_WhtTp> && !std::is_same_v<_WhtTp, bool>,
+        "Floyd: weight type should be arithmetic"
+    );
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "Floyd: index type should be integral"
+    );
+    static_assert(_Block > 0, "Floyd: block size should be positive");
+    typedef DistanceMatrix<_WhtTp> matrix_t;
+    constexpr _WhtTp inf = matrix_t::unreachable;
+
+    matrix_t result;
+    auto indexes = graph.allIndexes();
+    for (auto idx: indexes) {
+        result.size = std::max(result.size, static_cast<size_t>(idx) + 1);
+    }
+    if (result.size == 0) return result;
+    size_t blocks = (result.size + _Block - 1) / _Block;
+    size_t stride = result.stride = blocks * _Block;
+    result.data.assign(stride * stride, inf);
+    for (size_t i = 0; i < stride; ++i) result.data[i * stride + i] = _WhtTp();
+
+    // contiguous copy of adjacency
+    for (auto idx: indexes) {
+        _WhtTp* row = result.row(idx);
+        for (auto [to, wp]: graph.storage().forthRange(idx)) {
+            if (*wp < row[to]) row[to] = *wp;
+        }
+    }
+
+    auto tile = [&result, stride](size_t bi, size_t bj) {
+        return result.data.data() + bi * _Block * stride + bj * _Block;
+    };
+    general::utils::ThreadPool pool(thread_count);
+    for (size_t kb = 0; kb < blocks; ++kb) {
+        // phase 1: the diagonal tile depends only on itself
+        detail::floyd_tile(tile(kb, kb), tile(kb, kb), tile(kb, kb), stride, _Block);
+        if (blocks == 1) break;
+        // phase 2: tiles sharing the row or column of the diagonal one
+        pool.run(2 * (blocks - 1), [&](size_t task) {
+            size_t other = task % (blocks - 1);
+            if (other >= kb) ++other;
+            if (task < blocks - 1) {
+                detail::floyd_tile(
+                    tile(kb, other), tile(kb, kb), tile(kb, other), stride, _Block
+                );
+            } else {
+                detail::floyd_tile(
+                    tile(other, kb), tile(other, kb), tile(kb, kb), stride, _Block
+                );
+            }
+        });
+        // phase 3: all remaining tiles are independent of each other
+        pool.run((blocks - 1) * (blocks - 1), [&](size_t task) {
+            size_t bi = task / (blocks - 1), bj = task % (blocks - 1);
+            if (bi >= kb) ++bi;
+            if (bj >= kb) ++bj;
+            detail::floyd_tile(
+                tile(bi, bj), tile(bi, kb), tile(kb, bj), stride, _Block
+            );
+        });
+    }
+
+    if constexpr (!std::numeric_limits<_WhtTp>::has_infinity) {
+        // sums through unreachable pairs with negative edges drift below inf
+        for (auto& dist: result.data) {
+            if (dist > inf / 2) dist = inf;
+        }
+    }
+    return result;
+}
+
+/**
+ * 方向优化的并行 BFS（top-down / bottom-up 切换）
+ * 逐层同步扩展，每层在线程池上并行执行：
+ * -# 自顶向下：扫描边界结点的出边，通过原子位图认领未访问的结点；
+ * -# 自底向上：检查每个未访问结点的入边是否落在边界位图中，命中即停止。
+ * 边界的出边数超过未访问结点出边数的 1/_Alpha 时切换为自底向上，
+ * 边界缩小且结点数少于 n/_Beta 时切回自顶向下。
+ * 入边需要扫描全部结点的存储（见 utils::scans_back_range）只做自顶向下。
+ * 结果中 distance 为层数，previous 为 BFS 树中的父结点。
+ * @param target 所在层扩展完成后提前结束，nindex 表示遍历全部可达结点
+ * @param thread_count 线程数，0 表示使用硬件并发数
+ */
+template<
+    size_t _Alpha = 15, size_t _Beta = 18,
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+ShortestPaths<_IdxTp, size_t> ParallelBFS(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    const _IdxTp& source,
+    const _IdxTp& target = utils::index_limits<_IdxTp>::max(),
+    size_t thread_count = 0
+) {
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "ParallelBFS: index type should be integral"
+    );
+    typedef ShortestPaths<_IdxTp, size_t> result_t;
+    constexpr bool can_bottom_up = !utils::scans_back_range<_StProv>::value;
+    const _StProv& storage = graph.storage();
+
+    result_t result;
+    size_t n = 0;
+    for (auto idx: graph.allIndexes()) {
+        n = std::max(n, static_cast<size_t>(idx) + 1);
+    }
+    if (static_cast<size_t>(source) >= n) return result;
+    result.source = source;
+    result.distance.assign(n, result_t::unreachable);
+    result.previous.assign(n, result_t::nindex);
+    auto& distance = result.distance;
+    auto& previous = result.previous;
+
+    general::utils::ThreadPool pool(thread_count);
+    const size_t parts = pool.size() == 1 ? 1 : pool.size() * 8;
+    const size_t words = (n + 63) / 64;
+    auto lower = [parts](size_t total, size_t part) {
+        return total * part / parts;
+    };
+
+    std::vector<std::atomic<uint64_t>> visited(words);
+    for (auto& word: visited) word.store(0, std::memory_order_relaxed);
+    std::vector<uint64_t> front_bits, next_bits;
+    std::vector<size_t> degree, part_edges(parts), part_awake(parts);
+    std::vector<std::vector<_IdxTp>> part_next(parts);
+    // out-edges of unvisited vertices
+    size_t unexplored = 0;
+    if constexpr (can_bottom_up) {
+        degree.assign(n, 0);
+        pool.run(parts, [&](size_t part) {
+            size_t sum = 0;
+            for (size_t v = lower(n, part); v < lower(n, part + 1); ++v) {
+                degree[v] = storage.forthRange(static_cast<_IdxTp>(v)).count();
+                sum += degree[v];
+            }
+            part_edges[part] = sum;
+        });
+        for (auto sum: part_edges) unexplored += sum;
+        front_bits.assign(words, 0);
+        next_bits.assign(words, 0);
+    }
+
+    std::vector<_IdxTp> frontier(1, source);
+    size_t src = static_cast<size_t>(source);
+    visited[src >> 6].store(uint64_t(1) << (src & 63));
+    distance[src] = 0;
+    size_t level = 0, front_size = 1, last_size = 0, front_edges = 0;
+    if constexpr (can_bottom_up) {
+        front_edges = degree[src];
+        unexplored -= front_edges;
+    }
+    bool bottom_up = false;
+    size_t dest = static_cast<size_t>(target);
+
+    while (front_size > 0 && !(dest < n && distance[dest] != result_t::unreachable)) {
+        if constexpr (can_bottom_up) {
+            if (!bottom_up && front_edges > unexplored / _Alpha) {
+                std::fill(front_bits.begin(), front_bits.end(), 0);
+                for (auto v: frontier) {
+                    size_t i = static_cast<size_t>(v);
+                    front_bits[i >> 6] |= uint64_t(1) << (i & 63);
+                }
+                bottom_up = true;
+            } else if (
+                bottom_up && front_size < last_size && front_size < n / _Beta
+            ) {
+                frontier.clear();
+                for (size_t w = 0; w < words; ++w) {
+                    for (uint64_t bits = front_bits[w]; bits; bits &= bits - 1) {
+                        frontier.push_back(
+                            static_cast<_IdxTp>(w * 64 + std::countr_zero(bits))
+                        );
+                    }
+                }
+                bottom_up = false;
+            }
+        }
+        last_size = front_size;
+
+        if (!bottom_up) {
+            pool.run(parts, [&](size_t part) {
+                auto& next = part_next[part];
+                size_t edges = 0;
+                next.clear();
+                for (
+                    size_t i = lower(frontier.size(), part);
+                    i < lower(frontier.size(), part + 1);
+                    ++i
+                ) {
+                    _IdxTp u = frontier[i];
+                    for (auto [v, wp]: storage.forthRange(u)) {
+                        size_t vi = static_cast<size_t>(v);
+                        uint64_t bit = uint64_t(1) << (vi & 63);
+                        auto& word = visited[vi >> 6];
+                        if (word.load(std::memory_order_relaxed) & bit) continue;
+                        if (word.fetch_or(bit, std::memory_order_relaxed) & bit) continue;
+                        distance[vi] = level + 1;
+                        previous[vi] = u;
+                        next.push_back(v);
+                        if constexpr (can_bottom_up) edges += degree[vi];
+                    }
+                }
+                part_edges[part] = edges;
+            });
+            frontier.clear();
+            front_edges = 0;
+            for (size_t part = 0; part < parts; ++part) {
+                frontier.insert(
+                    frontier.end(), part_next[part].begin(), part_next[part].end()
+                );
+                front_edges += part_edges[part];
+            }
+            front_size = frontier.size();
+        } else if constexpr (can_bottom_up) {
+            pool.run(parts, [&](size_t part) {
+                size_t edges = 0, awake = 0;
+                for (size_t w = lower(words, part); w < lower(words, part + 1); ++w) {
+                    uint64_t fresh = 0;
+                    uint64_t todo = ~visited[w].load(std::memory_order_relaxed);
+                    for (; todo; todo &= todo - 1) {
+                        size_t v = w * 64 + std::countr_zero(todo);
+                        if (v >= n) break;
+                        for (auto [u, wp]: storage.backRange(static_cast<_IdxTp>(v))) {
+                            size_t ui = static_cast<size_t>(u);
+                            if (!((front_bits[ui >> 6] >> (ui & 63)) & 1)) continue;
+                            distance[v] = level + 1;
+                            previous[v] = u;
+                            fresh |= uint64_t(1) << (v & 63);
+                            edges += degree[v];
+                            ++awake;
+                            break;
+                        }
+                    }
+                    next_bits[w] = fresh;
+                    // each word belongs to exactly one part
+                    visited[w].fetch_or(fresh, std::memory_order_relaxed);
+                }
+                part_edges[part] = edges;
+                part_awake[part] = awake;
+            });
+            std::swap(front_bits, next_bits);
+            front_size = front_edges = 0;
+            for (size_t part = 0; part < parts; ++part) {
+                front_size += part_awake[part];
+                front_edges += part_edges[part];
+            }
+        }
+        if constexpr (can_bottom_up) unexplored -= front_edges;
+        ++level;
+    }
+    return result;
+}
+
+/**
+ * 点对点搜索的结果
+ * path 为从起点到终点的路径（含两端），不可达时为空；
+ * expanded 为扫描过邻接点的结点数。
+ */
+template<class _IdxTp>
+struct SearchPath {
+    typedef _IdxTp index_type;
+
+    std::vector<index_type> path;
+    size_t expanded;
+
+    SearchPath(): path(), expanded(0) { }
+
+    bool found() const { return !path.empty(); }
+
+    // number of edges on the path
+    size_t length() const {
+        return path.empty() ? std::numeric_limits<size_t>::max() : path.size() - 1;
+    }
+};
+
+/**
+ * 双向 BFS，求两点间边数最少的路径
+ * 从起点沿出边、从终点沿入边交替逐层扩展，每次扩展结点数较少的一侧；
+ * 某一层中两侧相遇后完成该层即可得到最短路径。
+ * 访问集合使用哈希表，开销只与实际访问的结点数相关。
+ */
+template<
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+SearchPath<_IdxTp> BidirectionalBFS(
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& from,
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& to
+) {
+    typedef accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    > __accessor;
+    // vertex => (neighbour towards own root, distance to own root)
+    typedef std::unordered_map<_IdxTp, std::pair<_IdxTp, size_t>> visit_map;
+    constexpr _IdxTp nindex = utils::index_limits<_IdxTp>::max();
+    constexpr size_t none = std::numeric_limits<size_t>::max();
+
+    SearchPath<_IdxTp> result;
+    if (from.invalid() || to.invalid()) return result;
+    if (from.raw() == to.raw()) {
+        result.path.push_back(from.raw());
+        return result;
+    }
+
+    visit_map seen[2];
+    std::vector<_IdxTp> frontier[2], next;
+    size_t radius[2] = {0, 0};
+    seen[0].emplace(from.raw(), std::make_pair(nindex, 0));
+    seen[1].emplace(to.raw(), std::make_pair(nindex, 0));
+    frontier[0].push_back(from.raw());
+    frontier[1].push_back(to.raw());
+
+    __accessor acc = from;
+    size_t best = none;
+    _IdxTp meet = nindex;
+    while (!frontier[0].empty() && !frontier[1].empty()) {
+        // side 0 walks out-edges from the source, side 1 in-edges from the target
+        size_t side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+        auto& mine = seen[side];
+        auto& other = seen[side ^ 1];
+        next.clear();
+        for (auto u: frontier[side]) {
+            acc.move(u);
+            ++result.expanded;
+            auto visit = [&](const _IdxTp& v) {
+                if (!mine.emplace(v, std::make_pair(u, radius[side] + 1)).second) return ;
+                next.push_back(v);
+                auto hit = other.find(v);
+                if (hit == other.end()) return ;
+                size_t length = radius[side] + 1 + hit->second.second;
+                if (length < best) {
+                    best = length;
+                    meet = v;
+                }
+            };
+            if (side == 0) {
+                for (auto [v, wp]: acc.forth().raw()) visit(v);
+            } else {
+                for (auto [v, wp]: acc.back().raw()) visit(v);
+            }
+        }
+        std::swap(frontier[side], next);
+        ++radius[side];
+        if (best != none) break;
+    }
+    if (best == none) return result;
+
+    for (_IdxTp v = meet; v != nindex; v = seen[0].at(v).first) {
+        result.path.push_back(v);
+    }
+    std::reverse(result.path.begin(), result.path.end());
+    for (_IdxTp v = seen[1].at(meet).first; v != nindex; v = seen[1].at(v).first) {
+        result.path.push_back(v);
+    }
+    return result;
+}
+
+/**
+ * A* 的结果，distance 为路径长度，未找到时为 unreachable
+ * 边权为 bool 时每条边的长度计为 1。
+ */
+template<class _IdxTp, class _DistTp>
+struct AStarPath: SearchPath<_IdxTp> {
+    typedef _DistTp distance_type;
+
+    static constexpr distance_type unreachable =
+        std::numeric_limits<distance_type>::has_infinity ?
+        std::numeric_limits<distance_type>::infinity() :
+        std::numeric_limits<distance_type>::max();
+
+    distance_type distance = unreachable;
+};
+
+/**
+ * A* 的工作区，在多次搜索之间复用内存
+ * open 为支持 decrease-key 的 d 叉堆，closed 为以下标为位的稠密位图，
+ * 只在估价函数声明为一致时使用；
+ * 每次搜索后只清理本次接触过的结点，代价与搜索规模相关而与图的大小无关。
+ */
+template<class _IdxTp, class _DistTp, size_t _Arity = 4>
+class AStarWorkspace {
+public:
+    typedef _IdxTp index_type;
+    typedef _DistTp distance_type;
+
+    static constexpr index_type nindex = utils::index_limits<index_type>::max();
+    static constexpr distance_type unreachable = AStarPath<_IdxTp, _DistTp>::unreachable;
+
+    utils::DaryHeap<_Arity, index_type, distance_type> open;
+    std::vector<distance_type> cost;
+    std::vector<index_type> previous;
+    std::vector<uint64_t> closed;
+    std::vector<index_type> touched;
+
+    AStarWorkspace(): open(), cost(), previous(), closed(), touched() { }
+
+    // grow arrays so that idx is addressable, recording it for clear()
+    void touch(const index_type& idx) {
+        size_t i = static_cast<size_t>(idx);
+        if (i >= cost.size()) {
+            size_t need = std::max(i + 1, cost.size() * 2);
+            cost.resize(need, unreachable);
+            previous.resize(need, nindex);
+            closed.resize((need + 63) >> 6, 0);
+        }
+        if (cost[i] == unreachable) touched.push_back(idx);
+    }
+
+    // untouched indexes are never closed
+    bool isClosed(const index_type& idx) const {
+        size_t i = static_cast<size_t>(idx);
+        return i < cost.size() && ((closed[i >> 6] >> (i & 63)) & 1);
+    }
+
+    void close(const index_type& idx) {
+        size_t i = static_cast<size_t>(idx);
+        closed[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    void clear() {
+        open.clear();
+        for (auto idx: touched) {
+            size_t i = static_cast<size_t>(idx);
+            cost[i] = unreachable;
+            previous[i] = nindex;
+            closed[i >> 6] = 0;
+        }
+        touched.clear();
+    }
+};
+
+/**
+ * A* 搜索 from 到 to 的最短路径
+ * heuristic(value, goal) 给出结点值 value 到终点值 goal 的距离下界，
+ * 估价函数类型带有值为真的静态成员 consistent 时视为一致（单调），
+ * 展开过的结点记入 closed 位图，之后指向它们的边不再读取代价与估价；
+ * 否则只要求可采纳，已展开的结点可能因更短的路径再次入堆展开，
+ * open 堆支持 decrease-key，不需要关闭集合。
+ * 估价恒为 0 时即为提前终止的 Dijkstra。
+ * 要求边权非负、下标为整数；边权为 bool 时按每条边长度 1 计算。
+ * 距离类型为边权（bool 时为 size_t）与估价结果的公共类型。
+ * result.expanded 为展开（弹出并扫描出边）的结点数。
+ * @param workspace 复用的工作区，搜索结束后被清理
+ */
+template<
+    size_t _Arity = 4,
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv, class _Heuristic,
+    class _DistTp = std::common_type_t<
+        std::conditional_t<std::is_same_v<_WhtTp, bool>, size_t, _WhtTp>,
+        std::invoke_result_t<_Heuristic&, const _ValTp&, const _ValTp&>
+    >
+>
+AStarPath<_IdxTp, _DistTp> AStar(
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& from,
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& to,
+    _Heuristic&& heuristic,
+    AStarWorkspace<_IdxTp, _DistTp, _Arity>& workspace
+) {
+    static_assert(
+        std::is_arithmetic_v<_WhtTp>,
+        "AStar: weight type should be arithmetic"
+    );
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "AStar: index type should be integral"
+    );
+    typedef accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    > __accessor;
+    constexpr _IdxTp nindex = utils::index_limits<_IdxTp>::max();
+    constexpr bool consistent = requires {
+        requires std::remove_cvref_t<_Heuristic>::consistent;
+    };
+
+    AStarPath<_IdxTp, _DistTp> result;
+    if (from.invalid() || to.invalid()) return result;
+
+    auto& ws = workspace;
+    const _ValTp& goal = *to;
+    const _IdxTp target = to.raw();
+    const auto& storage = from.storage();
+    __accessor probe = from;
+    ws.touch(from.raw());
+    ws.cost[from.raw()] = _DistTp();
+    ws.open.push(from.raw(), static_cast<_DistTp>(heuristic(*from, goal)));
+    while (!ws.open.empty()) {
+        _IdxTp u = ws.open.pop().second;
+        if (u == target) break;
+        if constexpr (consistent) ws.close(u);
+        ++result.expanded;
+        const _DistTp base = ws.cost[u];
+        detail::for_each_forth(storage, u, [&](const _IdxTp& v, const _WhtTp& weight) {
+            // a consistent heuristic settles a vertex the first time it is expanded
+            if constexpr (consistent) {
+                if (ws.isClosed(v)) return ;
+            }
+            _DistTp step;
+            if constexpr (std::is_same_v<_WhtTp, bool>) step = _DistTp(1);
+            else step = static_cast<_DistTp>(weight);
+            _DistTp relaxed = base + step;
+            ws.touch(v);
+            if (!(relaxed < ws.cost[v])) return ;
+            ws.cost[v] = relaxed;
+            ws.previous[v] = u;
+            probe.move(v);
+            _DistTp priority = relaxed + static_cast<_DistTp>(heuristic(*probe, goal));
+            ws.open.update(v, priority);
+        });
+    }
+    if (ws.cost.size() > static_cast<size_t>(target) && ws.cost[target] != ws.unreachable) {
+        result.distance = ws.cost[target];
+        for (_IdxTp v = target; v != nindex; v = ws.previous[v]) result.path.push_back(v);
+        std::reverse(result.path.begin(), result.path.end());
+    }
+    ws.clear();
+    return result;
+}
+
+/**
+ * A* 搜索，使用临时的工作区
+ */
+template<
+    size_t _Arity = 4,
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv, class _Heuristic
+>
+auto AStar(
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& from,
+    const accessors::GraphAccessor<
+        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv
+    >& to,
+    _Heuristic&& heuristic
+) {
+    typedef std::common_type_t<
+        std::conditional_t<std::is_same_v<_WhtTp, bool>, size_t, _WhtTp>,
+        std::invoke_result_t<_Heuristic&, const _ValTp&, const _ValTp&>
+    > dist_t;
+    AStarWorkspace<_IdxTp, dist_t, _Arity> workspace;
+    return AStar<_Arity>(from, to, std::forward<_Heuristic>(heuristic), workspace);
+}
+
+/**
+ * 连通分量的结果
+ * label[v] 为 v 所在分量中最小的下标，不存在的下标为 nindex。
+ */
+template<class _IdxTp>
+struct Components {
+    static constexpr _IdxTp nindex = utils::index_limits<_IdxTp>::max();
+
+    std::vector<_IdxTp> label;
+    size_t count = 0;
+
+    bool connected(const _IdxTp& a, const _IdxTp& b) const {
+        size_t i = static_cast<size_t>(a), j = static_cast<size_t>(b);
+        return i < label.size() && j < label.size() &&
+            label[i] != nindex && label[i] == label[j];
+    }
+};
+
+namespace detail {
+
+// lock-free hooking of the higher root under the lower one (Afforest)
+template<class _IdxTp>
+void afforest_link(std::vector<std::atomic<_IdxTp>>& parent, _IdxTp u, _IdxTp v) {
+    _IdxTp p1 = parent[u].load(), p2 = parent[v].load();
+    while (p1 != p2) {
+        _IdxTp high = std::max(p1, p2), low = std::min(p1, p2);
+        _IdxTp p_high = parent[high].load();
+        if (p_high == low) break;
+        if (p_high == high) {
+            _IdxTp expected = high;
+            if (parent[high].compare_exchange_strong(expected, low)) break;
+        }
+        p1 = parent[parent[high].load()].load();
+        p2 = parent[low].load();
+    }
+}
+
+template<class _IdxTp>
+void afforest_compress(std::vector<std::atomic<_IdxTp>>& parent, size_t v) {
+    while (true) {
+        _IdxTp p = parent[v].load();
+        _IdxTp gp = parent[p].load();
+        if (p == gp) break;
+        parent[v].store(gp);
+    }
+}
+
+}
+// namespace dsl::graph::algorithms::detail
+
+/**
+ * 并行求（弱）连通分量，Afforest 算法：
+ * -# 每个结点先与前 _Rounds 个邻接点合并，并压缩路径；
+ * -# 抽样找出最大的分量，之后只处理不在其中的结点的剩余邻接点
+ *    （有向图的边只在起点一侧可见，不能跳过，处理全部结点）。
+ * 合并使用无锁的 CAS 挂接，根始终为分量中最小的下标。
+ * @param thread_count 线程数，0 表示使用硬件并发数
+ */
+template<
+    size_t _Rounds = 2,
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+Components<_IdxTp> ConnectedComponents(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    size_t thread_count = 0
+) {
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "ConnectedComponents: index type should be integral"
+    );
+    typedef Components<_IdxTp> result_t;
+    const _StProv& storage = graph.storage();
+
+    result_t result;
+    auto indexes = graph.allIndexes();
+    size_t n = 0;
+    for (auto idx: indexes) n = std::max(n, static_cast<size_t>(idx) + 1);
+    if (n == 0) return result;
+
+    general::utils::ThreadPool pool(thread_count);
+    const size_t parts = pool.size() == 1 ? 1 : pool.size() * 8;
+    auto lower = [parts](size_t total, size_t part) {
+        return total * part / parts;
+    };
+    std::vector<std::atomic<_IdxTp>> parent(n);
+    for (size_t v = 0; v < n; ++v) parent[v].store(static_cast<_IdxTp>(v));
+    auto compress_all = [&] {
+        pool.run(parts, [&](size_t part) {
+            for (size_t v = lower(n, part); v < lower(n, part + 1); ++v) {
+                detail::afforest_compress(parent, v);
+            }
+        });
+    };
+
+    // neighbour sampling
+    for (size_t round = 0; round < _Rounds; ++round) {
+        pool.run(parts, [&](size_t part) {
+            for (size_t i = lower(indexes.size(), part); i < lower(indexes.size(), part + 1); ++i) {
+                size_t seen = 0;
+                for (auto [to, wp]: storage.forthRange(indexes[i])) {
+                    if (seen++ == round) {
+                        detail::afforest_link(parent, indexes[i], to);
+                        break;
+                    }
+                }
+            }
+        });
+        compress_all();
     }
 
-    size_t countVertex() const { return index_provider.size(); }
-    size_t countEdge() const { return storage_provider.size(); }
+    // most frequent root among a sample
+    _IdxTp largest = result_t::nindex;
+    if constexpr (!_Directed) {
+        std::unordered_map<_IdxTp, size_t> freq;
+        std::mt19937_64 engine(n);
+        std::uniform_int_distribution<size_t> pick(0, indexes.size() - 1);
+        size_t best = 0;
+        for (size_t s = 0; s < std::min<size_t>(1024, indexes.size()); ++s) {
+            _IdxTp root = parent[indexes[pick(engine)]].load();
+            size_t count = ++freq[root];
+            if (count > best) { best = count; largest = root; }
+        }
+    }
 
-    self& addEdge(
-        const index_type& from,
-        const index_type& to,
-        const weight_type& weight = null_weight::value()
-    ) {
-        if constexpr (std::is_same_v<weight_type, bool>) {
-            storage_provider.addEdge(from, to, true);
-        } else {
-            storage_provider.addEdge(from, to, weight);
+    // remaining neighbours
+    pool.run(parts, [&](size_t part) {
+        for (size_t i = lower(indexes.size(), part); i < lower(indexes.size(), part + 1); ++i) {
+            _IdxTp u = indexes[i];
+            if (largest != result_t::nindex && parent[u].load() == largest) continue;
+            size_t seen = 0;
+            for (auto [to, wp]: storage.forthRange(u)) {
+                if (seen++ < _Rounds) continue;
+                detail::afforest_link(parent, u, to);
+            }
         }
-        return *this;
+    });
+    compress_all();
+
+    result.label.assign(n, result_t::nindex);
+    for (auto idx: indexes) {
+        size_t v = static_cast<size_t>(idx);
+        result.label[v] = parent[v].load();
+        if (result.label[v] == idx) ++result.count;
     }
-    self& addEdgeByKey(
-        const key_type& key_from,
-        const key_type& key_to,
-        const weight_type& weight = null_weight::value()
-    ) {
-        return addEdge(
-            index_provider.find(key_from),
-            index_provider.find(key_to),
-            weight
+    return result;
+}
+
+/**
+ * PageRank 的结果
+ * score 以下标为索引，不存在的下标得分为 0；
+ * iteration_seconds 为每轮迭代的耗时，residual 为最后一轮的 L1 变化量。
+ */
+template<class _IdxTp>
+struct RankScores {
+    std::vector<double> score;
+    std::vector<double> iteration_seconds;
+    size_t iterations = 0;
+    double residual = 0;
+
+    /**
+     * 得分最高的至多 k 个结点（得分为正），按得分降序
+     */
+    std::vector<_IdxTp> top(size_t k) const {
+        std::vector<_IdxTp> order;
+        for (size_t v = 0; v < score.size(); ++v) {
+            if (score[v] > 0) order.push_back(static_cast<_IdxTp>(v));
+        }
+        k = std::min(k, order.size());
+        std::partial_sort(
+            order.begin(), order.begin() + k, order.end(),
+            [this](const _IdxTp& l, const _IdxTp& r) {
+                return score[l] > score[r];
+            }
         );
+        order.resize(k);
+        return order;
     }
+};
 
-    self& removeEdge(
-        const index_type& from,
-        const index_type& to
-    ) {
-        storage_provider.removeEdge(from, to);
-        return *this;
-    }
-    self& removeEdgeByKey(
-        const key_type& key_from,
-        const key_type& key_to
-    ) {
-        storage_provider.removeEdge(
-            index_provider.find(key_from),
-            index_provider.find(key_to)
-        );
-        return *this;
+/**
+ * 个性化 PageRank（拉取式、双缓冲、并行）
+ * 每轮每个结点从入边拉取 score[u] / outdeg[u]，写入另一份数组；
+ * 悬挂结点（无出边）的得分与跳转概率一起按 seeds 分配。
+ * 入边需要扫描全部结点的存储（见 utils::scans_back_range）先建立一份入边数组。
+ * @param seeds 跳转的目标结点，为空时为全部结点（即普通 PageRank）
+ * @param damping 阻尼系数
+ * @param tolerance 两轮得分的 L1 距离小于该值时停止
+ * @param max_iterations 迭代次数上限
+ * @param thread_count 线程数，0 表示使用硬件并发数
+ */
+template<
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+RankScores<_IdxTp> PersonalizedPageRank(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    const std::vector<_IdxTp>& seeds,
+    double damping = 0.85,
+    double tolerance = 1e-6,
+    size_t max_iterations = 100,
+    size_t thread_count = 0
+) {
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "PageRank: index type should be integral"
+    );
+    typedef std::chrono::steady_clock clock_type;
+    constexpr bool pull_direct = !utils::scans_back_range<_StProv>::value;
+    const _StProv& storage = graph.storage();
+
+    RankScores<_IdxTp> result;
+    auto indexes = graph.allIndexes();
+    size_t n = 0;
+    for (auto idx: indexes) n = std::max(n, static_cast<size_t>(idx) + 1);
+    if (n == 0) return result;
+
+    general::utils::ThreadPool pool(thread_count);
+    const size_t parts = pool.size() == 1 ? 1 : pool.size() * 8;
+    auto lower = [parts](size_t total, size_t part) {
+        return total * part / parts;
+    };
+
+    // teleport distribution
+    std::vector<double> teleport(n, 0);
+    if (seeds.empty()) {
+        for (auto idx: indexes) teleport[idx] = 1.0 / indexes.size();
+    } else {
+        size_t valid = 0;
+        for (auto s: seeds) valid += static_cast<size_t>(s) < n;
+        for (auto s: seeds) {
+            if (static_cast<size_t>(s) < n) teleport[s] += 1.0 / valid;
+        }
     }
 
-    const weight_type& getWeight(
-        const index_type& from,
-        const index_type& to
-    ) const {
-        return storage_provider.getWeight(from, to);
+    std::vector<size_t> out_degree(n, 0);
+    pool.run(parts, [&](size_t part) {
+        for (size_t i = lower(indexes.size(), part); i < lower(indexes.size(), part + 1); ++i) {
+            out_degree[indexes[i]] = storage.forthRange(indexes[i]).count();
+        }
+    });
+
+    // in-edge arrays for storages that cannot enumerate them cheaply
+    std::vector<size_t> in_offsets;
+    std::vector<_IdxTp> in_sources;
+    if constexpr (!pull_direct) {
+        in_offsets.assign(n + 1, 0);
+        for (auto u: indexes) {
+            for (auto [v, wp]: storage.forthRange(u)) ++in_offsets[static_cast<size_t>(v) + 1];
+        }
+        for (size_t v = 0; v < n; ++v) in_offsets[v + 1] += in_offsets[v];
+        in_sources.resize(in_offsets[n]);
+        std::vector<size_t> cursor(in_offsets.begin(), in_offsets.end() - 1);
+        for (auto u: indexes) {
+            for (auto [v, wp]: storage.forthRange(u)) in_sources[cursor[v]++] = u;
+        }
     }
-    const weight_type& getWeightByKey(
-        const key_type& key_from,
-        const key_type& key_to
-    ) const {
-        return storage_provider.getWeight(
-            index_provider.find(key_from),
-            index_provider.find(key_to)
+
+    std::vector<double> score(teleport), next(n, 0), contrib(n, 0);
+    std::vector<double> part_dangling(parts), part_residual(parts);
+    while (result.iterations < max_iterations) {
+        auto start = clock_type::now();
+        pool.run(parts, [&](size_t part) {
+            double dangling = 0;
+            for (size_t i = lower(indexes.size(), part); i < lower(indexes.size(), part + 1); ++i) {
+                size_t u = static_cast<size_t>(indexes[i]);
+                if (out_degree[u] == 0) dangling += score[u];
+                else contrib[u] = score[u] / out_degree[u];
+            }
+            part_dangling[part] = dangling;
+        });
+        double dangling = 0;
+        for (auto sum: part_dangling) dangling += sum;
+
+        pool.run(parts, [&](size_t part) {
+            double residual = 0;
+            for (size_t i = lower(indexes.size(), part); i < lower(indexes.size(), part + 1); ++i) {
+                size_t v = static_cast<size_t>(indexes[i]);
+                double pulled = 0;
+                if constexpr (pull_direct) {
+                    for (auto [u, wp]: storage.backRange(indexes[i])) pulled += contrib[u];
+                } else {
+                    for (size_t e = in_offsets[v]; e < in_offsets[v + 1]; ++e) {
+                        pulled += contrib[in_sources[e]];
+                    }
+                }
+                next[v] = (1 - damping) * teleport[v] +
+                    damping * (pulled + dangling * teleport[v]);
+                residual += std::abs(next[v] - score[v]);
+            }
+            part_residual[part] = residual;
+        });
+        score.swap(next);
+        result.residual = 0;
+        for (auto sum: part_residual) result.residual += sum;
+        ++result.iterations;
+        result.iteration_seconds.push_back(
+            std::chrono::duration<double>(clock_type::now() - start).count()
         );
+        if (result.residual < tolerance) break;
     }
+    result.score = std::move(score);
+    return result;
+}
 
-    void setWeight(
-        const index_type& from,
-        const index_type& to,
-        const weight_type& weight
-    ) {
-        storage_provider.setWeight(from, to, weight);
-    }
-    void setWeightByKey(
-        const key_type& key_from,
-        const key_type& key_to,
-        const weight_type& weight
-    ) {
-        storage_provider.setWeight(
-            index_provider.find(key_from),
-            index_provider.find(key_to),
-            weight
-        );
+/**
+ * PageRank，即跳转分布均匀的 PersonalizedPageRank
+ */
+template<
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+RankScores<_IdxTp> PageRank(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    double damping = 0.85,
+    double tolerance = 1e-6,
+    size_t max_iterations = 100,
+    size_t thread_count = 0
+) {
+    return PersonalizedPageRank(
+        graph, std::vector<_IdxTp>(), damping, tolerance, max_iterations, thread_count
+    );
+}
+
+/**
+ * 强连通分量的结果
+ * component[v] 为 v 所在分量的编号，不存在的下标为 npos；
+ * 编号按缩点图的拓扑序排列（边只会从编号小的分量指向编号大的分量）。
+ */
+template<class _IdxTp>
+struct StrongComponents {
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    std::vector<size_t> component;
+    size_t count = 0;
+
+    bool connected(const _IdxTp& a, const _IdxTp& b) const {
+        size_t i = static_cast<size_t>(a), j = static_cast<size_t>(b);
+        return i < component.size() && j < component.size() &&
+            component[i] != npos && component[i] == component[j];
     }
+};
 
-    value_type& operator[] (const index_type& index) {
-        return index_provider.at(index);
+/**
+ * Tarjan 强连通分量，基于 DepthFirst 迭代实现，O(V + E)
+ */
+template<
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+StrongComponents<_IdxTp> StronglyConnected(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph
+) {
+    typedef StrongComponents<_IdxTp> result_t;
+    constexpr size_t npos = result_t::npos;
+
+    result_t result;
+    auto indexes = graph.allIndexes();
+    size_t n = 0;
+    for (auto idx: indexes) n = std::max(n, static_cast<size_t>(idx) + 1);
+    result.component.assign(n, npos);
+
+    std::vector<size_t> order(n, npos), low(n, npos);
+    std::vector<_IdxTp> pending;
+    size_t counter = 0;
+    // components come out in reverse topological order, renumbered below
+    DepthFirst<_StProv> dfs(graph.storage());
+    for (auto root: indexes) {
+        dfs.run(
+            root,
+            [&](_IdxTp v) {
+                order[v] = low[v] = counter++;
+                pending.push_back(v);
+                return true;
+            },
+            [&](_IdxTp v, _IdxTp parent) {
+                if (low[v] == order[v]) {
+                    _IdxTp w;
+                    do {
+                        w = pending.back();
+                        pending.pop_back();
+                        result.component[w] = result.count;
+                    } while (w != v);
+                    ++result.count;
+                }
+                if (parent != DepthFirst<_StProv>::nindex) {
+                    low[parent] = std::min(low[parent], low[v]);
+                }
+            },
+            [&](_IdxTp u, _IdxTp v) {
+                // still pending means v is on the Tarjan stack
+                if (result.component[v] == npos) low[u] = std::min(low[u], order[v]);
+            }
+        );
     }
-    const value_type& operator[] (const index_type& index) const {
-        return index_provider.at(index);
+    for (auto idx: indexes) {
+        result.component[idx] = result.count - 1 - result.component[idx];
     }
+    return result;
+}
 
-    accessor access() {
-        index_type idx = index_provider.available();
-        if (idx != idx_limit::max()) {
-            return accessor(
-                &index_provider,
-                &storage_provider,
-                idx
-            );
-        } else {
-            return accessor(
-                nullptr,
-                nullptr,
-                idx
-            );
-        }
+/**
+ * Kahn 拓扑排序，O(V + E)
+ * 图中存在环时，环上以及环可达的结点不会出现在结果中，
+ * 因此结果短于结点数即说明有环。
+ */
+template<
+    class _ValTp, class _WhtTp, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+std::vector<_IdxTp> TopologicalSort(
+    const SimpleGraph<_ValTp, _WhtTp, true, _IdxTp, _StProv, _IdxProv>& graph
+) {
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "TopologicalSort: index type should be integral"
+    );
+    const _StProv& storage = graph.storage();
+    auto indexes = graph.allIndexes();
+    size_t n = 0;
+    for (auto idx: indexes) n = std::max(n, static_cast<size_t>(idx) + 1);
+
+    std::vector<size_t> in_degree(n, 0);
+    for (auto u: indexes) {
+        for (auto [v, wp]: storage.forthRange(u)) ++in_degree[v];
     }
-    accessor access(const index_type& init_idx) {
-        if (init_idx != idx_limit::max()) {
-            return accessor(
-                &index_provider,
-                &storage_provider,
-                init_idx
-            );
-        } else {
-            return accessor(
-                nullptr,
-                nullptr,
-                init_idx
-            );
-        }
+    // the result doubles as the FIFO queue
+    std::vector<_IdxTp> order;
+    order.reserve(indexes.size());
+    for (auto v: indexes) {
+        if (in_degree[v] == 0) order.push_back(v);
     }
-
-    const_accessor const_access() const {
-        index_type idx = index_provider.available();
-        if (idx != idx_limit::max()) {
-            return const_accessor(
-                &index_provider,
-                &storage_provider,
-                idx
-            );
-        } else {
-            return const_accessor(
-                nullptr,
-                nullptr,
-                idx
-            );
+    for (size_t head = 0; head < order.size(); ++head) {
+        for (auto [v, wp]: storage.forthRange(order[head])) {
+            if (--in_degree[v] == 0) order.push_back(v);
         }
     }
-    const_accessor const_access(const index_type& init_idx) const {
-        if (init_idx != idx_limit::max()) {
-            return const_accessor(
-                &index_provider,
-                &storage_provider,
-                init_idx
-            );
-        } else {
-            return const_accessor(
-                nullptr,
-                nullptr,
-                init_idx
-            );
+    return order;
+}
+
+/**
+ * 缩点：每个强连通分量成为新图中的一个结点（值与下标均为分量编号），
+ * 分量之间的多条边合并为一条；权重可比较时取最小值，否则取第一条。
+ * 分量内部的边被丢弃，结果为有向无环图。
+ * @tparam _Graph 结果的图类型，需使用按 0, 1, 2 ... 分配下标的下标提供器
+ */
+template<
+    class _Graph = void,
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+auto Condense(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    const StrongComponents<_IdxTp>& scc
+) {
+    typedef std::conditional_t<
+        std::is_void_v<_Graph>, SimpleGraph<size_t, _WhtTp, true>, _Graph
+    > graph_t;
+    typedef typename graph_t::edge_type edge_t;
+
+    graph_t result;
+    for (size_t c = 0; c < scc.count; ++c) result.emplaceNode(c);
+
+    std::vector<edge_t> edges;
+    for (auto u: graph.allIndexes()) {
+        size_t cu = scc.component[u];
+        for (auto [v, wp]: graph.storage().forthRange(u)) {
+            size_t cv = scc.component[v];
+            if (cu != cv) edges.emplace_back(cu, cv, *wp);
         }
     }
+    std::stable_sort(edges.begin(), edges.end(), [](const edge_t& l, const edge_t& r) {
+        if (std::get<0>(l) != std::get<0>(r)) return std::get<0>(l) < std::get<0>(r);
+        if (std::get<1>(l) != std::get<1>(r)) return std::get<1>(l) < std::get<1>(r);
+        if constexpr (std::totally_ordered<_WhtTp>) return std::get<2>(l) < std::get<2>(r);
+        else return false;
+    });
+    // bulkLoad keeps the last duplicate, so keep only the first of each run
+    edges.erase(
+        std::unique(edges.begin(), edges.end(), [](const edge_t& l, const edge_t& r) {
+            return std::get<0>(l) == std::get<0>(r) && std::get<1>(l) == std::get<1>(r);
+        }),
+        edges.end()
+    );
+    result.bulkLoad(edges, 1);
+    return result;
+}
+
+/**
+ * 结点的重排
+ * order[k] 为排在第 k 位的原下标，new_index[old] 为原下标 old 的新位置，
+ * 不存在的下标为 npos。
+ */
+template<class _IdxTp>
+struct Permutation {
+    static constexpr _IdxTp npos = utils::index_limits<_IdxTp>::max();
+
+    std::vector<_IdxTp> order;
+    std::vector<_IdxTp> new_index;
 
+    size_t size() const { return order.size(); }
 };
 
-namespace algorithms {
+namespace detail {
+
+template<class _IdxTp>
+Permutation<_IdxTp> make_permutation(std::vector<_IdxTp>&& order, size_t bound) {
+    Permutation<_IdxTp> result;
+    result.new_index.assign(bound, Permutation<_IdxTp>::npos);
+    for (size_t k = 0; k < order.size(); ++k) {
+        result.new_index[static_cast<size_t>(order[k])] = static_cast<_IdxTp>(k);
+    }
+    result.order = std::move(order);
+    return result;
+}
+
+// out-neighbours, plus in-neighbours of directed graphs when they are cheap to list
+template<class _StProv, bool _Directed, class _IdxTp, class _Fn>
+void for_each_neighbour(const _StProv& storage, const _IdxTp& u, _Fn&& fn) {
+    for (auto [v, wp]: storage.forthRange(u)) fn(v);
+    if constexpr (_Directed && !utils::scans_back_range<_StProv>::value) {
+        for (auto [v, wp]: storage.backRange(u)) fn(v);
+    }
+}
+
+}
+// namespace dsl::graph::algorithms::detail
 
+/**
+ * 按度数降序重排，度数相同时保持原有顺序
+ * 高度数结点集中在下标的前部，PageRank 等拉取式扫描反复读取的
+ * 热点数据落在少数连续的缓存行中。有向图的度数为入度与出度之和。
+ */
 template<
-    class _ValTp, class _WhtTp, class _IdxTp,
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
     class _StProv, class _IdxProv
 >
-void BFS(
-    const accessors::GraphAccessor<
-        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
-    >& accessor,
-    const typename accessors::GraphAccessor<
-        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
-    >::callback_t& on_node
+Permutation<_IdxTp> DegreeOrder(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph
 ) {
-    typedef accessors::GraphAccessor<
-        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
-    > __accessor;
-    std::unordered_set<_IdxTp> visited;
-    std::queue<__accessor> q;
-    if (accessor.invalid()) return ;
-    q.push(accessor);
-    visited.insert(accessor.raw());
-    while (!q.empty()) {
-        __accessor acc = q.front();
-        q.pop();
-        if (!on_node(*acc)) return ;
-        acc.updateAdjacent(defines::UpdateStrategy::forth);
-        for (auto [idx, vp, wp]: acc.listForth()) {
-            auto iter = visited.find(idx);
-            if (iter == visited.end()) {
-                q.push(acc.next(idx));
-                visited.insert(idx);
-            }
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "DegreeOrder: index type should be integral"
+    );
+    const _StProv& storage = graph.storage();
+    auto indexes = graph.allIndexes();
+    size_t n = 0;
+    for (auto idx: indexes) n = std::max(n, static_cast<size_t>(idx) + 1);
+
+    std::vector<size_t> degree(n, 0);
+    for (auto u: indexes) {
+        for (auto [v, wp]: storage.forthRange(u)) {
+            ++degree[u];
+            if constexpr (_Directed) ++degree[v];
         }
     }
+    std::sort(indexes.begin(), indexes.end());
+    std::stable_sort(indexes.begin(), indexes.end(), [&degree](_IdxTp l, _IdxTp r) {
+        return degree[l] > degree[r];
+    });
+    return detail::make_permutation(std::move(indexes), n);
 }
 
+/**
+ * 逆 Cuthill-McKee 重排，减小邻接矩阵的带宽
+ * 每个连通分量从一个伪外围结点（自最小度结点出发的 BFS 最后一层中度数最小者）开始 BFS，
+ * 同一结点的未访问邻居按度数升序入队，最后整体逆序。
+ * 相邻结点的新下标彼此接近，BFS 等按边扫描的算法访问的是连续的内存。
+ * 有向图按无向图处理；入边需要扫描全部结点的存储只使用出边，
+ * 此时伪外围结点未必能到达起始结点，起始结点未被访问时再从它自身 BFS 一次。
+ */
 template<
-    class _ValTp, class _WhtTp, class _IdxTp,
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
     class _StProv, class _IdxProv
 >
-void DFS(
-    const accessors::GraphAccessor<
-        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
-    >& accessor,
-    const typename accessors::GraphAccessor<
-        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
-    >::callback_t& on_node
+Permutation<_IdxTp> ReverseCuthillMcKee(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph
 ) {
-    typedef accessors::GraphAccessor<
-        _ValTp, _IdxTp, _WhtTp, _IdxProv, _StProv 
-    > __accessor;
-    std::unordered_set<_IdxTp> visited;
-    if (accessor.invalid()) return ;
-    visited.insert(accessor.raw());
+    static_assert(
+        std::is_integral_v<_IdxTp>,
+        "ReverseCuthillMcKee: index type should be integral"
+    );
+    const _StProv& storage = graph.storage();
+    auto indexes = graph.allIndexes();
+    size_t n = 0;
+    for (auto idx: indexes) n = std::max(n, static_cast<size_t>(idx) + 1);
+    auto neighbours = [&storage](const _IdxTp& u, auto&& fn) {
+        detail::for_each_neighbour<_StProv, _Directed>(storage, u, fn);
+    };
 
-    std::function<void(__accessor)> _rec = 
-    [&visited, &on_node, &_rec](__accessor acc) -> void {
-        if (!on_node(*acc)) return ;
-        acc.updateAdjacent(defines::UpdateStrategy::forth);
-        for (auto [idx, vp, wp]: acc.listForth()) {
-            auto iter = visited.find(idx);
-            if (iter == visited.end()) {
-                visited.insert(idx);
-                _rec(acc.next(idx));
+    std::vector<size_t> degree(n, 0);
+    for (auto u: indexes) neighbours(u, [&](const _IdxTp&) { ++degree[u]; });
+    std::sort(indexes.begin(), indexes.end(), [&degree](_IdxTp l, _IdxTp r) {
+        return degree[l] != degree[r] ? degree[l] < degree[r] : l < r;
+    });
+
+    std::vector<bool> visited(n, false);
+    // stamp[v] == round marks v as seen by the probing BFS of this round
+    std::vector<size_t> stamp(n, 0);
+    std::vector<_IdxTp> level, next_level;
+    size_t round = 0;
+    auto peripheral = [&](_IdxTp start) {
+        ++round;
+        stamp[start] = round;
+        level.assign(1, start);
+        while (true) {
+            next_level.clear();
+            for (auto u: level) {
+                neighbours(u, [&](const _IdxTp& v) {
+                    // with out-edges only, earlier components may still be reachable
+                    if (stamp[v] == round || visited[v]) return ;
+                    stamp[v] = round;
+                    next_level.push_back(v);
+                });
             }
+            if (next_level.empty()) break;
+            level.swap(next_level);
         }
+        return *std::min_element(level.begin(), level.end(), [&degree](_IdxTp l, _IdxTp r) {
+            return degree[l] < degree[r];
+        });
     };
-    _rec(accessor);
-}
-
-// TODO Single source shortest path
-void Dijkstra() {
 
+    std::vector<_IdxTp> order, fresh;
+    order.reserve(indexes.size());
+    auto sweep = [&](_IdxTp start) {
+        visited[start] = true;
+        // the result doubles as the FIFO queue
+        size_t head = order.size();
+        order.push_back(start);
+        while (head < order.size()) {
+            _IdxTp u = order[head++];
+            fresh.clear();
+            neighbours(u, [&](const _IdxTp& v) {
+                if (visited[v]) return ;
+                visited[v] = true;
+                fresh.push_back(v);
+            });
+            std::sort(fresh.begin(), fresh.end(), [&degree](_IdxTp l, _IdxTp r) {
+                return degree[l] != degree[r] ? degree[l] < degree[r] : l < r;
+            });
+            order.insert(order.end(), fresh.begin(), fresh.end());
+        }
+    };
+    for (auto seed: indexes) {
+        if (visited[seed]) continue;
+        sweep(peripheral(seed));
+        // with out-edges only the peripheral vertex may not reach seed
+        if (!visited[seed]) sweep(seed);
+    }
+    std::reverse(order.begin(), order.end());
+    return detail::make_permutation(std::move(order), n);
 }
 
-// TODO Multiple source shortest path
-void Floyd() {
-
+/**
+ * 按重排构造新图：结点按 perm.order 的顺序加入，边映射到新下标后批量加载
+ * 结点值与权值被复制，存储与下标提供器均重新建立。
+ * @tparam _Graph 结果的图类型，默认与原图相同；需使用按 0, 1, 2 ... 分配下标的下标提供器，
+ * 此时原下标 old 在新图中的下标为 perm.new_index[old]
+ */
+template<
+    class _Graph = void,
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+auto Reorder(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    const Permutation<_IdxTp>& perm
+) {
+    typedef SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv> source_t;
+    typedef std::conditional_t<std::is_void_v<_Graph>, source_t, _Graph> graph_t;
+    typedef typename graph_t::edge_type edge_t;
+    typedef typename graph_t::index_type index_t;
+
+    graph_t result;
+    for (auto old: perm.order) result.addNode(graph[old]);
+
+    std::vector<edge_t> edges;
+    for (auto old: perm.order) {
+        index_t u = static_cast<index_t>(perm.new_index[old]);
+        for (auto [w, wp]: graph.storage().forthRange(old)) {
+            index_t v = static_cast<index_t>(perm.new_index[w]);
+            // undirected edges appear at both ends, bulkLoad wants them once
+            if constexpr (!_Directed) {
+                if (v < u) continue;
+            }
+            edges.emplace_back(u, v, *wp);
+        }
+    }
+    result.bulkLoad(edges, 1);
+    return result;
 }
 
 }
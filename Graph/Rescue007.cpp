@@ -0,0 +1,60 @@
+/**
+ * 拯救 007
+ * Build: g++ -std=c++20 -O3 -march=native Rescue007.cpp -o rescue
+ * Usage: rescue             读入 "N D" 与 N 行 "x y"，输出最少跳跃次数与路线
+ *        rescue bench [N]   随机生成 N 只鳄鱼并计时
+ */
+
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <string>
+#include "Rescue007.hpp"
+
+using namespace dsl::graph::rescue;
+
+int bench(size_t count) {
+    std::mt19937_64 engine(20240523);
+    std::uniform_real_distribution<double> coord(-50.0, 50.0);
+    Rescue007 rescue(0.12);
+    for (size_t i = 0; i < count; ++i) rescue.add(coord(engine), coord(engine));
+
+    auto start = std::chrono::steady_clock::now();
+    Escape escape = rescue.solve();
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << count << " crocodiles: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+        << " ms, " << escape.expanded << " expanded, ";
+    if (escape.found) std::cout << escape.jumps << " jumps\n";
+    else std::cout << "no escape\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        return bench(argc > 2 ? std::stoul(argv[2]) : 1000000);
+    }
+
+    size_t count;
+    double jump;
+    if (!(std::cin >> count >> jump)) return 0;
+    Rescue007 rescue(jump);
+    for (size_t i = 0; i < count; ++i) {
+        double x, y;
+        std::cin >> x >> y;
+        rescue.add(x, y);
+    }
+
+    Escape escape = rescue.solve();
+    if (!escape.found) {
+        std::cout << 0 << '\n';
+        return 0;
+    }
+    std::cout << escape.jumps << '\n';
+    for (size_t idx: escape.path) {
+        const Crocodile& croc = rescue.graph()[idx];
+        std::cout << croc.x << ' ' << croc.y << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,355 @@
+
+#ifndef _DSL_GRAPH_RESCUE007_HPP_
+#define _DSL_GRAPH_RESCUE007_HPP_
+
+#include "Graph.hpp"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace dsl {
+namespace graph {
+namespace rescue {
+
+struct Crocodile {
+    double x, y;
+    bool operator==(const Crocodile&) const = default;
+};
+
+/**
+ * 以均匀网格组织鳄鱼坐标的存储
+ * 边是隐式的：两只鳄鱼的距离不超过跳跃距离即相邻，
+ * 邻接点只在以结点所在格为中心的若干格内查找，不保存任何边。
+ * 格的边长为 jump / sqrt(2)，同一格内的点两两可达；
+ * 查找窗口为以跳跃距离为半径的圆的外接正方形覆盖的格子，每边至多 4 格。
+ * 湖岸上、湖外以及岛上的鳄鱼不进入网格，没有邻接点。
+ * addEdge / removeEdge / setWeight 被忽略；build() 之后结点集合不再改变。
+ * 边没有可写的权重：forthRange 给出游标自带的 true，
+ * getForth / getBack 给出的指针共用一个每次调用都重置为 true 的占位值。
+ */
+class GridStorage {
+public:
+    typedef size_t index_type;
+    typedef bool weight_type;
+    typedef utils::null_weight<weight_type> null_weight;
+
+    /**
+     * 网格：第 c 格中的结点为 items[offsets[c], offsets[c + 1])，
+     * c = cy * side + cx
+     */
+    struct storage_type {
+        double cell = 1;
+        size_t side = 0;
+        std::vector<size_t> offsets;
+        std::vector<size_t> items;
+    };
+
+    static constexpr weight_type fallback = null_weight::value();
+    static constexpr double lake_half = 50;
+    static constexpr double island_radius = 7.5;
+
+private:
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef utils::index_limits<index_type> idx_limit;
+
+    static constexpr weight_type present = true;
+
+    std::vector<Crocodile> points;
+    std::vector<bool> placed;
+    storage_type grid;
+    double jump;
+    // shared by the pairs of one getForth / getBack call
+    mutable weight_type placeholder = true;
+
+    size_t cell_of(double v) const {
+        double c = std::floor((v + lake_half) / grid.cell);
+        if (c < 0) return 0;
+        return std::min(static_cast<size_t>(c), grid.side - 1);
+    }
+
+    bool near(size_t a, size_t b) const {
+        double dx = points[a].x - points[b].x, dy = points[a].y - points[b].y;
+        return dx * dx + dy * dy <= jump * jump;
+    }
+
+public:
+    GridStorage(): points(), placed(), grid(), jump(0) { }
+
+    /**
+     * 用给定的坐标与跳跃距离重建网格，下标即坐标在 pts 中的位置。O(n)
+     */
+    void build(const std::vector<Crocodile>& pts, double jump_distance) {
+        points = pts;
+        jump = jump_distance;
+        // cap the grid at 1024 x 1024 cells for tiny jumps
+        grid.cell = std::max(jump / std::sqrt(2.0), 2 * lake_half / 1024);
+        grid.side = static_cast<size_t>(std::ceil(2 * lake_half / grid.cell));
+        placed.assign(points.size(), false);
+        grid.offsets.assign(grid.side * grid.side + 1, 0);
+        for (size_t i = 0; i < points.size(); ++i) {
+            auto [x, y] = points[i];
+            if (std::abs(x) >= lake_half || std::abs(y) >= lake_half) continue;
+            if (x * x + y * y <= island_radius * island_radius) continue;
+            placed[i] = true;
+            ++grid.offsets[cell_of(y) * grid.side + cell_of(x) + 1];
+        }
+        for (size_t c = 0; c + 1 < grid.offsets.size(); ++c) {
+            grid.offsets[c + 1] += grid.offsets[c];
+        }
+        grid.items.resize(grid.offsets.back());
+        std::vector<size_t> cursor(grid.offsets.begin(), grid.offsets.end() - 1);
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (!placed[i]) continue;
+            grid.items[cursor[cell_of(points[i].y) * grid.side + cell_of(points[i].x)]++] = i;
+        }
+    }
+
+    double jumpDistance() const { return jump; }
+    const Crocodile& point(index_type idx) const { return points[idx]; }
+    bool placedInLake(index_type idx) const { return idx < placed.size() && placed[idx]; }
+    const storage_type& cells() const { return grid; }
+
+    /**
+     * 与圆 (x, y, radius) 的外接正方形相交的格子范围 [x0, x1] x [y0, y1]
+     */
+    std::tuple<size_t, size_t, size_t, size_t> window(
+        double x, double y, double radius
+    ) const {
+        return {
+            cell_of(x - radius), cell_of(x + radius),
+            cell_of(y - radius), cell_of(y + radius)
+        };
+    }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return &grid; }
+
+    /**
+     * [StorageProvider.sync]
+     */
+    void sync(size_t) { }
+
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(const index_type&) { }
+
+    /**
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(const index_type&) { return idx_limit::max(); }
+
+    /**
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(const index_type&, const index_type&, const weight_type&) { }
+
+    /**
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(const index_type&, const index_type&) { }
+
+    /**
+     * [StorageProvider.getWeight]
+     */
+    const weight_type& getWeight(const index_type& from, const index_type& to) const {
+        if (!placedInLake(from) || !placedInLake(to) || from == to) return fallback;
+        return near(from, to) ? present : fallback;
+    }
+
+    /**
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(const index_type&, const index_type&, const weight_type&) { }
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(const index_type& idx, contain_type& contain) const {
+        if (!placeholder) placeholder = true;
+        for (auto [v, wp]: forthRange(idx)) contain.emplace_back(v, &placeholder);
+    }
+
+    /**
+     * [StorageProvider.getBack]
+     */
+    void getBack(const index_type& idx, contain_type& contain) const {
+        getForth(idx, contain);
+    }
+
+    // walks the window cell by cell, keeping points within the jump
+    struct window_cursor {
+        typedef size_t index_type;
+        typedef bool weight_type;
+        const GridStorage* store;
+        size_t self, x0, x1, y1, cx, cy, pos, end;
+        mutable weight_type mark = true;
+
+        void load() {
+            size_t c = cy * store->grid.side + cx;
+            pos = store->grid.offsets[c];
+            end = store->grid.offsets[c + 1];
+        }
+        void seek() {
+            while (true) {
+                while (pos < end) {
+                    size_t other = store->grid.items[pos];
+                    if (other != self && store->near(self, other)) return ;
+                    ++pos;
+                }
+                if (cx < x1) ++cx;
+                else if (cy < y1) { cx = x0; ++cy; }
+                else return ;
+                load();
+            }
+        }
+        bool done() const { return pos >= end; }
+        void next() { ++pos; mark = true; seek(); }
+        index_type index() const { return store->grid.items[pos]; }
+        weight_type* weight() const { return &mark; }
+    };
+
+    /**
+     * 可跳达的鳄鱼，惰性地在窗口内的格子中查找
+     */
+    utils::AdjacentRange<window_cursor> forthRange(const index_type& idx) const {
+        window_cursor cursor{this, idx, 0, 0, 0, 0, 0, 0, 0};
+        if (placedInLake(idx)) {
+            auto [x0, x1, y0, y1] = window(points[idx].x, points[idx].y, jump);
+            cursor.x0 = cursor.cx = x0;
+            cursor.x1 = x1;
+            cursor.cy = y0;
+            cursor.y1 = y1;
+            cursor.load();
+            cursor.seek();
+        }
+        return utils::AdjacentRange<window_cursor>(cursor);
+    }
+
+    utils::AdjacentRange<window_cursor> backRange(const index_type& idx) const {
+        return forthRange(idx);
+    }
+};
+
+/**
+ * 逃生路线
+ * path 为依次踩过的鳄鱼下标，jumps 为跳跃次数（path.size() + 1），
+ * 无法逃生时 found 为 false；expanded 为搜索中展开过的鳄鱼数。
+ */
+struct Escape {
+    bool found = false;
+    size_t jumps = 0;
+    std::vector<size_t> path;
+    size_t expanded = 0;
+};
+
+/**
+ * 拯救 007：湖为以 (0, 0) 为中心、边长 100 的正方形，
+ * 岛为以 (0, 0) 为圆心、直径 15 的圆。
+ * 鳄鱼作为结点存放在以 GridStorage 为存储的 SimpleGraph 中，
+ * solve() 在网格上按层 BFS 求跳跃次数最少的路线；
+ * 次数相同时优先第一跳最短的路线。
+ */
+class Rescue007 {
+public:
+    typedef SimpleGraph<
+        Crocodile, bool, false, size_t,
+        GridStorage,
+        DenseIndexProvider<Crocodile, size_t, false>
+    > graph_type;
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+    graph_type g;
+    double jump;
+
+    bool reaches_shore(const Crocodile& c) const {
+        return GridStorage::lake_half - std::abs(c.x) <= jump ||
+            GridStorage::lake_half - std::abs(c.y) <= jump;
+    }
+
+public:
+    explicit Rescue007(double jump_distance): g(), jump(jump_distance) { }
+
+    /**
+     * 加入一只鳄鱼，返回其下标（按加入顺序从 0 开始）
+     */
+    size_t add(double x, double y) { return g.emplaceNode(Crocodile{x, y}); }
+
+    graph_type& graph() { return g; }
+    const graph_type& graph() const { return g; }
+
+    /**
+     * 建立网格并搜索，O(n) 建网格，搜索中每只鳄鱼至多入队一次。
+     * 第一跳在岛周围的窗口中查找，之后的每一层沿存储的 forthRange 展开。
+     */
+    Escape solve() {
+        Escape result;
+        const double first_reach = GridStorage::island_radius + jump;
+        if (first_reach >= GridStorage::lake_half) {
+            result.found = true;
+            result.jumps = 1;
+            return result;
+        }
+
+        size_t n = g.countVertex();
+        std::vector<Crocodile> points(n);
+        for (size_t i = 0; i < n; ++i) points[i] = g[i];
+        GridStorage& grid = g.storage();
+        grid.build(points, jump);
+        const auto& cells = grid.cells();
+
+        std::vector<size_t> previous(n, npos), queue;
+        std::vector<bool> queued(n, false);
+        queue.reserve(n);
+
+        // first jump from the island edge, shortest first
+        auto [x0, x1, y0, y1] = grid.window(0, 0, first_reach);
+        for (size_t cy = y0; cy <= y1; ++cy) {
+            for (size_t cx = x0; cx <= x1; ++cx) {
+                size_t c = cy * cells.side + cx;
+                for (size_t pos = cells.offsets[c]; pos < cells.offsets[c + 1]; ++pos) {
+                    const Crocodile& p = points[cells.items[pos]];
+                    if (p.x * p.x + p.y * p.y > first_reach * first_reach) continue;
+                    queued[cells.items[pos]] = true;
+                    queue.push_back(cells.items[pos]);
+                }
+            }
+        }
+        std::sort(queue.begin(), queue.end(), [&points](size_t l, size_t r) {
+            const Crocodile& a = points[l];
+            const Crocodile& b = points[r];
+            return a.x * a.x + a.y * a.y < b.x * b.x + b.y * b.y;
+        });
+
+        for (size_t head = 0; head < queue.size(); ++head) {
+            size_t u = queue[head];
+            if (reaches_shore(points[u])) {
+                for (size_t v = u; v != npos; v = previous[v]) result.path.push_back(v);
+                std::reverse(result.path.begin(), result.path.end());
+                result.found = true;
+                result.jumps = result.path.size() + 1;
+                result.expanded = head + 1;
+                return result;
+            }
+            for (auto [v, wp]: grid.forthRange(u)) {
+                if (queued[v]) continue;
+                queued[v] = true;
+                previous[v] = u;
+                queue.push_back(v);
+            }
+        }
+        result.expanded = queue.size();
+        return result;
+    }
+};
+
+}}}
+// namespace dsl::graph::rescue
+
+#endif /* _DSL_GRAPH_RESCUE007_HPP_ */
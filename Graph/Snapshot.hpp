@@ -0,0 +1,815 @@
+
+#ifndef _DSL_GRAPH_SNAPSHOT_HPP_
+#define _DSL_GRAPH_SNAPSHOT_HPP_
+
+#include "Graph.hpp"
+
+#include <string>
+#include <fstream>
+#include <memory>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DSL_SNAPSHOT_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace dsl {
+namespace graph {
+namespace snapshot {
+
+/**
+ * 结点值的序列化器
+ * 平凡可复制的类型直接按字节写入；其余类型需特化该结构体，
+ * 特化时需重写的函数如下：
+ * -# static void write(std::ostream&, const T&)
+ * -# static T read(const char*& cursor, const char* end)
+ * read 从 cursor 处读取一个值并将 cursor 移动到其后，
+ * [cursor, end) 中剩余的字节不足时抛出 std::runtime_error。
+ * 仍接受只有 read(const char*& cursor) 的特化，此时只能在读完后检查是否越过 end。
+ */
+template<class T>
+struct serializer {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "snapshot::serializer: specialize it for this value type"
+    );
+    static void write(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    static T read(const char*& cursor, const char* end) {
+        if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+            throw std::runtime_error("snapshot: truncated value section");
+        }
+        T value;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+};
+
+// length-prefixed string
+template<>
+struct serializer<std::string> {
+    static void write(std::ostream& os, const std::string& value) {
+        uint64_t length = value.size();
+        os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        os.write(value.data(), value.size());
+    }
+    static std::string read(const char*& cursor, const char* end) {
+        uint64_t length;
+        if (static_cast<size_t>(end - cursor) < sizeof(length)) {
+            throw std::runtime_error("snapshot: truncated value section");
+        }
+        std::memcpy(&length, cursor, sizeof(length));
+        cursor += sizeof(length);
+        if (static_cast<size_t>(end - cursor) < length) {
+            throw std::runtime_error("snapshot: truncated value section");
+        }
+        std::string value(cursor, length);
+        cursor += length;
+        return value;
+    }
+};
+
+/**
+ * 快照文件头
+ * 各段均按 64 字节对齐，偏移量相对于文件起始位置。
+ * 快照与生成它的平台绑定（字节序、类型大小以及 std::hash 的实现）。
+ */
+struct Header {
+    static constexpr char signature[8] = {'D', 'S', 'L', 'G', 'R', 'A', 'P', 'H'};
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint32_t endian_mark = 0x01020304;
+
+    // flags
+    static constexpr uint32_t directed = 1;
+    static constexpr uint32_t raw_values = 2;
+    static constexpr uint32_t key_table = 4;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint32_t flags;
+    uint32_t index_size;
+    uint32_t weight_size;
+    uint32_t value_size;
+
+    uint64_t vertex_count;
+    // entries in the target array, undirected edges are stored twice
+    uint64_t entry_count;
+    uint64_t edge_count;
+    uint64_t key_slots;
+
+    uint64_t values_offset, values_length;
+    uint64_t keys_offset;
+    uint64_t offsets_offset, targets_offset, weights_offset;
+    uint64_t rev_offsets_offset, rev_sources_offset, rev_slots_offset;
+};
+
+// slot of the key table, index is stored plus one so that zero means empty
+struct KeySlot {
+    uint64_t hash;
+    uint64_t index;
+};
+
+namespace detail {
+
+// offsets[0 .. n] must start at zero, never decrease and end at entries
+inline void check_offsets(const uint64_t* offsets, uint64_t n, uint64_t entries) {
+    bool valid = offsets[0] == 0 && offsets[n] == entries;
+    for (uint64_t i = 0; valid && i < n; ++i) valid = offsets[i] <= offsets[i + 1];
+    if (!valid) throw std::runtime_error("snapshot: corrupt offset section");
+}
+
+// every element of arr[0, count) must be below bound
+template<class T>
+void check_below(const T* arr, uint64_t count, uint64_t bound) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (static_cast<uint64_t>(arr[i]) >= bound) {
+            throw std::runtime_error("snapshot: corrupt index section");
+        }
+    }
+}
+
+}
+// namespace dsl::graph::snapshot::detail
+
+/**
+ * 只读映射的快照文件
+ * POSIX 平台上以私有可写方式 mmap 整个文件（写入只影响本进程的副本），
+ * 其余平台读入内存缓冲区。打开失败或文件头不匹配时抛出 std::runtime_error。
+ */
+class Mapping {
+private:
+    char* base;
+    size_t length;
+#ifndef DSL_SNAPSHOT_MMAP
+    std::unique_ptr<uint64_t[]> buffer;
+#endif
+
+public:
+    explicit Mapping(const std::string& path): base(nullptr), length(0) {
+#ifdef DSL_SNAPSHOT_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("snapshot: can not open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("snapshot: can not stat " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length >= sizeof(Header)) {
+            void* addr = ::mmap(
+                nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0
+            );
+            if (addr != MAP_FAILED) base = static_cast<char*>(addr);
+        }
+        ::close(fd);
+        if (base == nullptr) {
+            throw std::runtime_error("snapshot: can not map " + path);
+        }
+#else
+        std::ifstream reader(path, std::ios::binary | std::ios::ate);
+        if (!reader) throw std::runtime_error("snapshot: can not open " + path);
+        length = static_cast<size_t>(reader.tellg());
+        buffer.reset(new uint64_t[(length + 7) / 8]);
+        base = reinterpret_cast<char*>(buffer.get());
+        reader.seekg(0);
+        if (length < sizeof(Header) || !reader.read(base, length)) {
+            throw std::runtime_error("snapshot: can not read " + path);
+        }
+#endif
+        const Header& h = header();
+        if (
+            length < sizeof(Header) ||
+            std::memcmp(h.magic, Header::signature, sizeof(h.magic)) != 0
+        ) {
+            release();
+            throw std::runtime_error("snapshot: bad signature in " + path);
+        }
+        if (h.version != Header::current_version || h.endian != Header::endian_mark) {
+            release();
+            throw std::runtime_error("snapshot: unsupported version or byte order");
+        }
+    }
+    ~Mapping() { release(); }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    void release() {
+#ifdef DSL_SNAPSHOT_MMAP
+        if (base != nullptr) ::munmap(base, length);
+#else
+        buffer.reset();
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(base); }
+
+    /**
+     * 从 offset 开始的 count 个 T，超出文件范围或未对齐时抛出 std::runtime_error
+     */
+    template<class T>
+    T* section(uint64_t offset, uint64_t count) const {
+        if (
+            offset > length || offset % alignof(T) != 0 ||
+            count > (length - offset) / sizeof(T)
+        ) {
+            throw std::runtime_error("snapshot: section out of range");
+        }
+        return reinterpret_cast<T*>(base + offset);
+    }
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+/**
+ * 基于快照映射的只读 CSR 存储
+ * 邻接数组直接指向映射区域，不做任何解析。
+ * 拓扑结构不可修改：addEdge / removeEdge / removeIndex 被忽略，
+ * setWeight 只修改本进程的私有副本。
+ */
+template<class _IdxTp, class _WhtTp, bool _Directed>
+class MappedCsrStorage {
+public:
+    typedef _IdxTp index_type;
+    typedef _WhtTp weight_type;
+    typedef Mapping storage_type;
+    typedef utils::null_weight<weight_type> null_weight;
+
+    static constexpr weight_type fallback = null_weight::value();
+
+private:
+    typedef std::vector<std::pair<index_type, weight_type*>> contain_type;
+    typedef utils::index_limits<index_type> idx_limit;
+
+    std::shared_ptr<Mapping> mapping;
+    size_t vex_size, edge_count;
+    const uint64_t* offsets;
+    const index_type* targets;
+    weight_type* weights;
+    const uint64_t* rev_offsets;
+    const index_type* rev_sources;
+    const uint64_t* rev_slots;
+
+    size_t locate(index_type from, index_type to) const {
+        if (static_cast<size_t>(from) >= vex_size) return npos;
+        const index_type* beg = targets + offsets[from];
+        const index_type* end = targets + offsets[from + 1];
+        const index_type* iter = std::lower_bound(beg, end, to);
+        if (iter == end || *iter != to) return npos;
+        return static_cast<size_t>(iter - targets);
+    }
+
+public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    MappedCsrStorage():
+        mapping(), vex_size(0), edge_count(0),
+        offsets(nullptr), targets(nullptr), weights(nullptr),
+        rev_offsets(nullptr), rev_sources(nullptr), rev_slots(nullptr)
+    { }
+
+    /**
+     * 绑定快照映射，类型或方向与快照不符时抛出 std::runtime_error
+     * 各段的范围、偏移数组以及其中的下标均会被检查一遍，
+     * 截断或损坏的文件同样抛出 std::runtime_error，此时原有的绑定保持不变。
+     */
+    void attach(const std::shared_ptr<Mapping>& m) {
+        const Header& h = m->header();
+        if (
+            h.index_size != sizeof(index_type) ||
+            h.weight_size != sizeof(weight_type) ||
+            static_cast<bool>(h.flags & Header::directed) != _Directed
+        ) {
+            throw std::runtime_error("snapshot: storage type does not match");
+        }
+        // every vertex owns at least one offset, so a larger count can not fit
+        if (h.vertex_count >= m->size() || h.edge_count > h.entry_count) {
+            throw std::runtime_error("snapshot: corrupt header");
+        }
+        uint64_t n = h.vertex_count, entries = h.entry_count;
+        auto* new_offsets = m->section<const uint64_t>(h.offsets_offset, n + 1);
+        auto* new_targets = m->section<const index_type>(h.targets_offset, entries);
+        auto* new_weights = m->section<weight_type>(h.weights_offset, entries);
+        detail::check_offsets(new_offsets, n, entries);
+        detail::check_below(new_targets, entries, n);
+        if constexpr (_Directed) {
+            auto* new_rev_offsets = m->section<const uint64_t>(h.rev_offsets_offset, n + 1);
+            auto* new_rev_sources = m->section<const index_type>(h.rev_sources_offset, entries);
+            auto* new_rev_slots = m->section<const uint64_t>(h.rev_slots_offset, entries);
+            detail::check_offsets(new_rev_offsets, n, entries);
+            detail::check_below(new_rev_sources, entries, n);
+            detail::check_below(new_rev_slots, entries, entries);
+            rev_offsets = new_rev_offsets;
+            rev_sources = new_rev_sources;
+            rev_slots = new_rev_slots;
+        }
+        mapping = m;
+        vex_size = n;
+        edge_count = h.edge_count;
+        offsets = new_offsets;
+        targets = new_targets;
+        weights = new_weights;
+    }
+
+    size_t size() const { return edge_count; }
+
+    /**
+     * [StorageProvider.expose]
+     */
+    storage_type* expose() { return mapping.get(); }
+
+    /**
+     * [StorageProvider.sync]
+     */
+    void sync(size_t) { }
+
+    /**
+     * [StorageProvider.addIndex]
+     */
+    void addIndex(const index_type&) { }
+
+    /**
+     * [StorageProvider.removeIndex]
+     */
+    index_type removeIndex(const index_type&) { return idx_limit::max(); }
+
+    /**
+     * [StorageProvider.addEdge]
+     */
+    void addEdge(const index_type&, const index_type&, const weight_type&) { }
+
+    /**
+     * [StorageProvider.removeEdge]
+     */
+    void removeEdge(const index_type&, const index_type&) { }
+
+    /**
+     * [StorageProvider.getWeight]
+     */
+    const weight_type& getWeight(
+        const index_type& from,
+        const index_type& to
+    ) const {
+        size_t pos = locate(from, to);
+        return pos == npos ? fallback : weights[pos];
+    }
+
+    /**
+     * [StorageProvider.setWeight]
+     */
+    void setWeight(
+        const index_type& from,
+        const index_type& to,
+        const weight_type& weight
+    ) {
+        size_t pos = locate(from, to);
+        if (pos == npos) return ;
+        weights[pos] = weight;
+        if constexpr (!_Directed) {
+            pos = locate(to, from);
+            if (pos != npos) weights[pos] = weight;
+        }
+    }
+
+    /**
+     * [StorageProvider.getForth]
+     */
+    void getForth(const index_type& idx, contain_type& contain) const {
+        for (auto pair: forthRange(idx)) contain.push_back(pair);
+    }
+
+    /**
+     * [StorageProvider.getBack]
+     */
+    void getBack(const index_type& idx, contain_type& contain) const {
+        for (auto pair: backRange(idx)) contain.push_back(pair);
+    }
+
+    // walks ids[pos, end) with weights[slots[pos]] (or weights[pos])
+    struct slice_cursor {
+        typedef _IdxTp index_type;
+        typedef _WhtTp weight_type;
+        const index_type* ids;
+        const uint64_t* slots;
+        weight_type* weights;
+        size_t pos, end;
+
+        bool done() const { return pos >= end; }
+        void next() { ++pos; }
+        index_type index() const { return ids[pos]; }
+        weight_type* weight() const {
+            return weights + (slots == nullptr ? pos : slots[pos]);
+        }
+    };
+
+    /**
+     * 出边的惰性区间
+     */
+    utils::AdjacentRange<slice_cursor> forthRange(const index_type& idx) const {
+        slice_cursor cursor{targets, nullptr, weights, 0, 0};
+        if (static_cast<size_t>(idx) < vex_size) {
+            cursor.pos = offsets[idx];
+            cursor.end = offsets[idx + 1];
+        }
+        return utils::AdjacentRange<slice_cursor>(cursor);
+    }
+
+    /**
+     * 出边终点，为映射区域中连续的一段
+     */
+    std::span<const index_type> forthSpan(const index_type& idx) const {
+        if (static_cast<size_t>(idx) >= vex_size) return {};
+        return std::span<const index_type>(targets + offsets[idx], offsets[idx + 1] - offsets[idx]);
+    }
+
+    /**
+     * 与 forthSpan 一一对应的权重
+     */
+    std::span<const weight_type> forthWeights(const index_type& idx) const {
+        if (static_cast<size_t>(idx) >= vex_size) return {};
+        return std::span<const weight_type>(weights + offsets[idx], offsets[idx + 1] - offsets[idx]);
+    }
+
+    /**
+     * 入边的惰性区间
+     */
+    utils::AdjacentRange<slice_cursor> backRange(const index_type& idx) const {
+        if constexpr (!_Directed) {
+            return forthRange(idx);
+        } else {
+            slice_cursor cursor{rev_sources, rev_slots, weights, 0, 0};
+            if (static_cast<size_t>(idx) < vex_size) {
+                cursor.pos = rev_offsets[idx];
+                cursor.end = rev_offsets[idx + 1];
+            }
+            return utils::AdjacentRange<slice_cursor>(cursor);
+        }
+    }
+};
+
+/**
+ * 基于快照映射的下标提供器
+ * 键到下标的反向表直接在映射区域中探测；
+ * 平凡可复制的结点值同样直接引用映射区域，其余类型在绑定时反序列化。
+ * 之后插入的结点保存在内存中，删除只会将结点从查找结果中隐藏。
+ */
+template<class _ValTp, class _IdxTp>
+class MappedIndexProvider {
+public:
+    typedef _ValTp value_type;
+    typedef _IdxTp index_type;
+    typedef utils::key_selector<value_type>::key_type key_type;
+private:
+    typedef utils::key_selector<value_type> select_key;
+    typedef utils::index_limits<_IdxTp> limit;
+    static constexpr bool raw = std::is_trivially_copyable_v<value_type>;
+    static constexpr bool hashable = general::utils::is_hashable_v<key_type>;
+
+    std::shared_ptr<Mapping> mapping;
+    value_type* base;
+    size_t base_count;
+    std::vector<value_type> values;
+    const KeySlot* keys;
+    size_t key_slots, key_limit;
+    std::unordered_map<key_type, index_type> extra_keys;
+    std::unordered_set<index_type> removed;
+
+    size_t total() const { return base_count + values.size(); }
+
+    index_type probe(const key_type& key) const {
+        if (keys == nullptr) return limit::max();
+        uint64_t hash = std::hash<key_type>()(key);
+        size_t mask = key_slots - 1;
+        size_t i = hash & mask;
+        for (size_t step = 0; step < key_slots && keys[i].index != 0; ++step, i = (i + 1) & mask) {
+            // slots pointing past the stored vertices come from a corrupt file
+            if (keys[i].hash != hash || keys[i].index > key_limit) continue;
+            index_type idx = static_cast<index_type>(keys[i].index - 1);
+            if (select_key::key(at(idx)) == key) return idx;
+        }
+        return limit::max();
+    }
+
+public:
+    MappedIndexProvider():
+        mapping(), base(nullptr), base_count(0), values(),
+        keys(nullptr), key_slots(0), key_limit(0), extra_keys(), removed()
+    { }
+
+    /**
+     * 绑定快照映射，值类型与快照不符时抛出 std::runtime_error
+     * 值段与键表超出文件范围时同样抛出 std::runtime_error，此时原有的绑定保持不变。
+     */
+    void attach(const std::shared_ptr<Mapping>& m) {
+        const Header& h = m->header();
+        if (static_cast<bool>(h.flags & Header::raw_values) != raw) {
+            throw std::runtime_error("snapshot: value type does not match");
+        }
+        const KeySlot* new_keys = nullptr;
+        size_t new_slots = 0;
+        if (h.flags & Header::key_table) {
+            // probing masks with key_slots - 1, so it has to be a power of two
+            if (h.key_slots == 0 || (h.key_slots & (h.key_slots - 1)) != 0) {
+                throw std::runtime_error("snapshot: corrupt key table");
+            }
+            new_keys = m->section<const KeySlot>(h.keys_offset, h.key_slots);
+            new_slots = h.key_slots;
+        }
+        value_type* new_base = nullptr;
+        std::vector<value_type> new_values;
+        if constexpr (raw) {
+            if (h.value_size != sizeof(value_type)) {
+                throw std::runtime_error("snapshot: value type does not match");
+            }
+            new_base = m->section<value_type>(h.values_offset, h.vertex_count);
+        } else {
+            // non-trivial values have to be rebuilt, move them into memory
+            const char* cursor = m->section<const char>(h.values_offset, h.values_length);
+            const char* end = cursor + h.values_length;
+            // a corrupt vertex count must not turn into a huge reservation
+            new_values.reserve(std::min<uint64_t>(h.vertex_count, h.values_length));
+            for (size_t i = 0; i < h.vertex_count; ++i) {
+                if constexpr (requires { serializer<value_type>::read(cursor, end); }) {
+                    new_values.push_back(serializer<value_type>::read(cursor, end));
+                } else {
+                    new_values.push_back(serializer<value_type>::read(cursor));
+                    if (cursor > end) throw std::runtime_error("snapshot: truncated value section");
+                }
+            }
+        }
+        mapping = m;
+        base = new_base;
+        base_count = raw ? h.vertex_count : 0;
+        values = std::move(new_values);
+        keys = new_keys;
+        key_slots = new_slots;
+        key_limit = h.vertex_count;
+        extra_keys.clear();
+        removed.clear();
+    }
+
+    void allIndexes(std::vector<index_type>& contain) const {
+        for (size_t i = 0; i < total(); ++i) {
+            index_type idx = static_cast<index_type>(i);
+            if (!removed.contains(idx)) contain.emplace_back(idx);
+        }
+    }
+
+    index_type insert(const value_type& node) {
+        index_type idx = static_cast<index_type>(total());
+        values.push_back(node);
+        if constexpr (hashable) extra_keys.emplace(select_key::key(values.back()), idx);
+        return idx;
+    }
+    template<class... Args>
+    index_type emplace(Args&&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    void remove(index_type index) {
+        if (static_cast<size_t>(index) < total()) removed.insert(index);
+    }
+    void rewind(index_type) { }
+
+    size_t size() const { return total() - removed.size(); }
+
+    index_type find(const key_type& key) const {
+        index_type idx = limit::max();
+        if constexpr (hashable) {
+            idx = probe(key);
+            if (idx == limit::max()) {
+                auto iter = extra_keys.find(key);
+                if (iter != extra_keys.cend()) idx = iter->second;
+            }
+        } else {
+            for (size_t i = 0; i < total(); ++i) {
+                if (select_key::key(at(static_cast<index_type>(i))) == key) {
+                    idx = static_cast<index_type>(i);
+                    break;
+                }
+            }
+        }
+        if (idx != limit::max() && removed.contains(idx)) return limit::max();
+        return idx;
+    }
+
+    std::vector<index_type> findAll(const key_type& key) const {
+        std::vector<index_type> results;
+        index_type idx = find(key);
+        if (idx != limit::max()) results.push_back(idx);
+        return results;
+    }
+
+    const value_type& at(index_type index) const {
+        size_t i = static_cast<size_t>(index);
+        return i < base_count ? base[i] : values[i - base_count];
+    }
+    value_type& at(index_type index) {
+        size_t i = static_cast<size_t>(index);
+        return i < base_count ? base[i] : values[i - base_count];
+    }
+
+    index_type available() const {
+        for (size_t i = 0; i < total(); ++i) {
+            index_type idx = static_cast<index_type>(i);
+            if (!removed.contains(idx)) return idx;
+        }
+        return limit::max();
+    }
+};
+
+namespace detail {
+
+inline void pad(std::ostream& os, uint64_t align = 64) {
+    static const char zeros[64] = {};
+    uint64_t at = static_cast<uint64_t>(os.tellp());
+    if (at % align) os.write(zeros, align - at % align);
+}
+
+template<class T>
+inline uint64_t put_array(std::ostream& os, const std::vector<T>& arr) {
+    pad(os);
+    uint64_t at = static_cast<uint64_t>(os.tellp());
+    os.write(reinterpret_cast<const char*>(arr.data()), arr.size() * sizeof(T));
+    return at;
+}
+
+}
+// namespace dsl::graph::snapshot::detail
+
+/**
+ * 将图写入快照文件
+ * 结点按下标升序重新编号为 0 ... V-1，邻接关系按 CSR 格式写出，
+ * 有向图额外写出按终点分组的反向索引。
+ * 要求下标为整数、边权平凡可复制。写入失败时抛出 std::runtime_error。
+ */
+template<
+    class _ValTp, class _WhtTp, bool _Directed, class _IdxTp,
+    class _StProv, class _IdxProv
+>
+void save(
+    const SimpleGraph<_ValTp, _WhtTp, _Directed, _IdxTp, _StProv, _IdxProv>& graph,
+    const std::string& path
+) {
+    static_assert(std::is_integral_v<_IdxTp>, "snapshot: index type should be integral");
+    static_assert(
+        std::is_trivially_copyable_v<_WhtTp>,
+        "snapshot: weight type should be trivially copyable"
+    );
+    typedef typename utils::key_selector<_ValTp>::key_type key_type;
+    constexpr bool raw = std::is_trivially_copyable_v<_ValTp>;
+    constexpr bool hashable = general::utils::is_hashable_v<key_type>;
+
+    auto indexes = graph.allIndexes();
+    std::sort(indexes.begin(), indexes.end());
+    size_t n = indexes.size();
+    size_t bound = n == 0 ? 0 : static_cast<size_t>(indexes.back()) + 1;
+    std::vector<_IdxTp> remap(bound, utils::index_limits<_IdxTp>::max());
+    for (size_t i = 0; i < n; ++i) remap[indexes[i]] = static_cast<_IdxTp>(i);
+
+    // forward CSR under the new numbering
+    std::vector<uint64_t> offsets(n + 1, 0);
+    std::vector<_IdxTp> targets;
+    std::vector<_WhtTp> weights;
+    std::vector<std::pair<_IdxTp, _WhtTp>> row;
+    size_t self_loops = 0;
+    for (size_t i = 0; i < n; ++i) {
+        row.clear();
+        for (auto [to, wp]: graph.storage().forthRange(indexes[i])) {
+            row.emplace_back(remap[to], *wp);
+        }
+        std::sort(row.begin(), row.end(), [](const auto& l, const auto& r) {
+            return l.first < r.first;
+        });
+        for (auto& [to, weight]: row) {
+            targets.push_back(to);
+            weights.push_back(weight);
+            if (static_cast<size_t>(to) == i) ++self_loops;
+        }
+        offsets[i + 1] = targets.size();
+    }
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, Header::signature, sizeof(h.magic));
+    h.version = Header::current_version;
+    h.endian = Header::endian_mark;
+    h.flags = (_Directed ? Header::directed : 0) | (raw ? Header::raw_values : 0);
+    h.index_size = sizeof(_IdxTp);
+    h.weight_size = sizeof(_WhtTp);
+    h.value_size = raw ? sizeof(_ValTp) : 0;
+    h.vertex_count = n;
+    h.entry_count = targets.size();
+    h.edge_count = _Directed ? targets.size() : (targets.size() + self_loops) / 2;
+
+    std::ofstream writer(path, std::ios::binary | std::ios::trunc);
+    if (!writer) throw std::runtime_error("snapshot: can not write " + path);
+    writer.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    // vertex values
+    detail::pad(writer);
+    h.values_offset = static_cast<uint64_t>(writer.tellp());
+    for (auto idx: indexes) {
+        if constexpr (raw) {
+            writer.write(reinterpret_cast<const char*>(&graph[idx]), sizeof(_ValTp));
+        } else {
+            serializer<_ValTp>::write(writer, graph[idx]);
+        }
+    }
+    h.values_length = static_cast<uint64_t>(writer.tellp()) - h.values_offset;
+
+    // key table, open addressing with linear probing at load factor <= 1/2
+    if constexpr (hashable) {
+        size_t slots = 16;
+        while (slots < n * 2) slots <<= 1;
+        std::vector<KeySlot> table(slots, KeySlot{0, 0});
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t hash = std::hash<key_type>()(
+                utils::key_selector<_ValTp>::key(graph[indexes[i]])
+            );
+            size_t at = hash & (slots - 1);
+            while (table[at].index != 0) at = (at + 1) & (slots - 1);
+            table[at] = KeySlot{hash, i + 1};
+        }
+        h.flags |= Header::key_table;
+        h.key_slots = slots;
+        h.keys_offset = detail::put_array(writer, table);
+    }
+
+    h.offsets_offset = detail::put_array(writer, offsets);
+    h.targets_offset = detail::put_array(writer, targets);
+    h.weights_offset = detail::put_array(writer, weights);
+
+    if constexpr (_Directed) {
+        std::vector<uint64_t> rev_offsets(n + 1, 0), rev_slots(targets.size());
+        std::vector<_IdxTp> rev_sources(targets.size());
+        for (auto to: targets) ++rev_offsets[static_cast<size_t>(to) + 1];
+        for (size_t i = 0; i < n; ++i) rev_offsets[i + 1] += rev_offsets[i];
+        std::vector<uint64_t> cursor(rev_offsets.begin(), rev_offsets.end() - 1);
+        for (size_t from = 0; from < n; ++from) {
+            for (uint64_t e = offsets[from]; e < offsets[from + 1]; ++e) {
+                uint64_t at = cursor[targets[e]]++;
+                rev_sources[at] = static_cast<_IdxTp>(from);
+                rev_slots[at] = e;
+            }
+        }
+        h.rev_offsets_offset = detail::put_array(writer, rev_offsets);
+        h.rev_sources_offset = detail::put_array(writer, rev_sources);
+        h.rev_slots_offset = detail::put_array(writer, rev_slots);
+    }
+
+    detail::pad(writer);
+    writer.seekp(0);
+    writer.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    if (!writer) throw std::runtime_error("snapshot: can not write " + path);
+}
+
+/**
+ * 从快照加载的只读图
+ */
+template<class _ValTp, class _WhtTp, bool _Directed, class _IdxTp = size_t>
+using MappedGraph = SimpleGraph<
+    _ValTp, _WhtTp, _Directed, _IdxTp,
+    MappedCsrStorage<_IdxTp, _WhtTp, _Directed>,
+    MappedIndexProvider<_ValTp, _IdxTp>
+>;
+
+/**
+ * 映射快照文件并绑定到 MappedGraph
+ * 边与键表不做解析，只检查各段的范围与下标；非平凡的结点值在此时反序列化。
+ * 存储与下标提供器都绑定成功后才替换图中原有的绑定，任一段出错时图保持不变。
+ */
+template<class _ValTp, class _WhtTp, bool _Directed, class _IdxTp>
+void load(
+    MappedGraph<_ValTp, _WhtTp, _Directed, _IdxTp>& graph,
+    const std::string& path
+) {
+    auto mapping = std::make_shared<Mapping>(path);
+    MappedCsrStorage<_IdxTp, _WhtTp, _Directed> storage;
+    MappedIndexProvider<_ValTp, _IdxTp> index;
+    storage.attach(mapping);
+    index.attach(mapping);
+    graph.storage() = std::move(storage);
+    graph.indexProvider() = std::move(index);
+}
+
+}}}
+// namespace dsl::graph::snapshot
+
+#ifdef DSL_SNAPSHOT_MMAP
+#undef DSL_SNAPSHOT_MMAP
+#endif
+
+#endif /* _DSL_GRAPH_SNAPSHOT_HPP_ */
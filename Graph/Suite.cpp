@@ -0,0 +1,257 @@
+/**
+ * Graph benchmark suite, CSV output
+ * Build: g++ -std=c++20 -O3 -march=native -pthread Suite.cpp -o suite
+ * Usage: suite [scale] [edge factor] [dense scale] > result.csv
+ *
+ * Every generator (R-MAT, Erdős–Rényi, 2D grid) is loaded into every storage
+ * provider. Matrix providers use 2^[dense scale] vertices at most.
+ * Columns: generator,provider,vertices,edges,metric,value
+ * Metrics:
+ *   add_edge_per_s     addEdge throughput after all vertices exist
+ *   finalize_ms        freeze() after the addEdge loop, if the provider has one
+ *   bytes_per_edge     heap growth from the empty graph to the loaded one
+ *   allocs_per_edge    operator new calls while loading, per edge
+ *   release_ms         destroying the loaded graph
+ *   bfs_edges_per_s    algorithms::BFS from vertex 0, edges scanned per second
+ *   dfs_edges_per_s    algorithms::DFS from vertex 0, edges scanned per second
+ *   get_forth_ns       mean latency of getForth on random vertices
+ *   get_back_ns        mean latency of getBack on random vertices
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <algorithm>
+#include "Graph.hpp"
+#include "Generators.hpp"
+
+using namespace dsl::graph;
+
+// live heap bytes, tracked through the global operator new / delete
+static std::atomic<long long> live_bytes{0};
+static std::atomic<long long> allocations{0};
+
+// each block carries its size in a header that keeps max_align_t alignment
+static constexpr size_t header_size = alignof(std::max_align_t);
+
+// kept out of line so the compiler does not pair the inlined malloc / free
+// with new / delete expressions and warn about the header offset
+[[gnu::noinline]] void* operator new(size_t size) {
+    void* raw = std::malloc(size + header_size);
+    if (raw == nullptr) throw std::bad_alloc();
+    *static_cast<size_t*>(raw) = size;
+    live_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<char*>(raw) + header_size;
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) return ;
+    void* raw = static_cast<char*>(ptr) - header_size;
+    live_bytes.fetch_sub(
+        static_cast<long long>(*static_cast<size_t*>(raw)), std::memory_order_relaxed
+    );
+    std::free(raw);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+// over-aligned blocks (std::pmr pools ask for these) pad the header up to the alignment
+static size_t aligned_header(std::align_val_t align) {
+    return std::max(header_size, static_cast<size_t>(align));
+}
+
+[[gnu::noinline]] void* operator new(size_t size, std::align_val_t align) {
+    size_t alignment = static_cast<size_t>(align), header = aligned_header(align);
+    size_t total = (size + header + alignment - 1) / alignment * alignment;
+    void* raw = std::aligned_alloc(alignment, total);
+    if (raw == nullptr) throw std::bad_alloc();
+    char* ptr = static_cast<char*>(raw) + header;
+    *reinterpret_cast<size_t*>(ptr - sizeof(size_t)) = size;
+    live_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::align_val_t align) noexcept {
+    if (ptr == nullptr) return ;
+    char* raw = static_cast<char*>(ptr) - aligned_header(align);
+    live_bytes.fetch_sub(
+        static_cast<long long>(*reinterpret_cast<size_t*>(static_cast<char*>(ptr) - sizeof(size_t))),
+        std::memory_order_relaxed
+    );
+    std::free(raw);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t align) noexcept {
+    operator delete(ptr, align);
+}
+
+typedef std::chrono::steady_clock clock_type;
+
+template<class Fn>
+double timeSeconds(Fn&& fn) {
+    auto start = clock_type::now();
+    fn();
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+typedef generators::EdgeList<size_t, int> edge_list;
+
+struct Workload {
+    std::string name;
+    edge_list sparse, dense;
+};
+
+struct Row {
+    const std::string& generator;
+    const char* provider;
+    const edge_list& list;
+
+    void operator()(const char* metric, double value) const {
+        std::cout << generator << ',' << provider << ','
+            << list.vertex << ',' << list.edges.size() << ','
+            << metric << ',' << value << '\n';
+    }
+};
+
+// edges scanned by a traversal that reached the given vertices
+template<class _Graph>
+size_t scannedEdges(const _Graph& g, const std::vector<size_t>& reached) {
+    size_t total = 0;
+    for (auto v: reached) total += g.storage().forthRange(v).count();
+    return total;
+}
+
+template<class _Graph>
+void benchProvider(const char* provider, const std::string& generator, const edge_list& list) {
+    typedef typename _Graph::weight_type weight_t;
+    Row row{generator, provider, list};
+    if (list.vertex == 0) return ;
+
+    long long before = live_bytes.load(), allocs_before = allocations.load();
+    auto* g = new _Graph();
+    for (size_t i = 0; i < list.vertex; ++i) g->emplaceNode(i);
+    double add_s = timeSeconds([&] {
+        for (auto& [from, to, weight]: list.edges) {
+            g->addEdge(from, to, static_cast<weight_t>(weight));
+        }
+    });
+    row("add_edge_per_s", list.edges.size() / add_s);
+    if constexpr (requires { g->storage().freeze(); }) {
+        row("finalize_ms", timeSeconds([&] { g->storage().freeze(); }) * 1000);
+    }
+    long long after = live_bytes.load();
+    size_t edge_total = std::max<size_t>(list.edges.size(), 1);
+    row("bytes_per_edge", static_cast<double>(after - before) / edge_total);
+    row("allocs_per_edge", static_cast<double>(allocations.load() - allocs_before) / edge_total);
+
+    std::vector<size_t> reached;
+    reached.reserve(list.vertex);
+    double bfs_s = timeSeconds([&] {
+        algorithms::BFS(g->const_access(0), [&](const size_t& v) {
+            reached.push_back(v);
+            return true;
+        });
+    });
+    row("bfs_edges_per_s", scannedEdges(*g, reached) / bfs_s);
+    reached.clear();
+    double dfs_s = timeSeconds([&] {
+        algorithms::DFS(g->const_access(0), [&](const size_t& v) {
+            reached.push_back(v);
+            return true;
+        });
+    });
+    row("dfs_edges_per_s", scannedEdges(*g, reached) / dfs_s);
+
+    constexpr size_t probes = 20000;
+    std::mt19937_64 engine(20240525);
+    std::uniform_int_distribution<size_t> pick(0, list.vertex - 1);
+    std::vector<size_t> sample(probes);
+    for (auto& v: sample) v = pick(engine);
+    std::vector<std::pair<size_t, weight_t*>> adjacent;
+    size_t sink = 0;
+    double forth_s = timeSeconds([&] {
+        for (auto v: sample) {
+            adjacent.clear();
+            g->storage().getForth(v, adjacent);
+            sink += adjacent.size();
+        }
+    });
+    double back_s = timeSeconds([&] {
+        for (auto v: sample) {
+            adjacent.clear();
+            g->storage().getBack(v, adjacent);
+            sink += adjacent.size();
+        }
+    });
+    row("get_forth_ns", forth_s * 1e9 / probes);
+    row("get_back_ns", back_s * 1e9 / probes);
+    if (sink == 0) std::cerr << "no adjacency in " << generator << '\n';
+    row("release_ms", timeSeconds([&] { delete g; }) * 1000);
+}
+
+template<class _WhtTp, bool _Directed = true, bool _Arena = false>
+using HashGraph = SimpleGraph<
+    size_t, _WhtTp, _Directed, size_t, HashListStorage<size_t, _WhtTp, _Directed, true, _Arena>
+>;
+
+void benchWorkload(const Workload& w) {
+    benchProvider<HashGraph<int>>("HashListStorage", w.name, w.sparse);
+    benchProvider<HashGraph<int, true, true>>("HashListStorage(arena)", w.name, w.sparse);
+    benchProvider<SimpleGraph<size_t, int, true, size_t, FlatHashStorage<size_t, int, true, true>>>(
+        "FlatHashStorage", w.name, w.sparse
+    );
+    benchProvider<SimpleGraph<size_t, int, true, size_t, CsrStorage<size_t, int, true>>>(
+        "CsrStorage", w.name, w.sparse
+    );
+    benchProvider<SimpleGraph<
+        size_t, int, true, size_t,
+        ConcurrentStorage<HashListStorage<size_t, int, true, true>>
+    >>("ConcurrentStorage", w.name, w.sparse);
+    benchProvider<SimpleGraph<size_t, int, true, size_t, MatrixStorage<size_t, int, true>>>(
+        "MatrixStorage", w.name, w.dense
+    );
+    benchProvider<SimpleGraph<size_t, int, true, size_t, FlatMatrixStorage<size_t, int, true>>>(
+        "FlatMatrixStorage", w.name, w.dense
+    );
+    benchProvider<SimpleGraph<size_t, bool, true, size_t, BitMatrixStorage<size_t, true>>>(
+        "BitMatrixStorage", w.name, w.dense
+    );
+}
+
+int main(int argc, char* argv[]) {
+    size_t scale = 16, edge_factor = 16, dense_scale = 12;
+    if (argc > 1) scale = std::stoul(argv[1]);
+    if (argc > 2) edge_factor = std::stoul(argv[2]);
+    if (argc > 3) dense_scale = std::stoul(argv[3]);
+    dense_scale = std::min(scale, dense_scale);
+
+    std::vector<Workload> workloads;
+    workloads.push_back({
+        "rmat",
+        generators::RMat<size_t, int>(scale, edge_factor, 1),
+        generators::RMat<size_t, int>(dense_scale, edge_factor, 1)
+    });
+    workloads.push_back({
+        "erdos_renyi",
+        generators::ErdosRenyi<size_t, int>(size_t(1) << scale, edge_factor << scale, 2),
+        generators::ErdosRenyi<size_t, int>(size_t(1) << dense_scale, edge_factor << dense_scale, 2)
+    });
+    size_t side = size_t(1) << (scale / 2), dense_side = size_t(1) << (dense_scale / 2);
+    workloads.push_back({
+        "grid2d",
+        generators::Grid2D<size_t, int>(side, side, 3),
+        generators::Grid2D<size_t, int>(dense_side, dense_side, 3)
+    });
+
+    std::cout << "generator,provider,vertices,edges,metric,value\n";
+    for (auto& w: workloads) benchWorkload(w);
+    return 0;
+}
@@ -1,7 +1,6 @@
 
 #include <iostream>
 #include <string>
-#include <stack>
 #include "Graph.hpp"
 
 using dsl::graph::defines::UpdateStrategy;
@@ -37,7 +36,7 @@ struct utils::key_selector<Person> {
 int main() {
     SimpleGraph<
         Person, bool, false, size_t,
-        HashListStorage<size_t, bool, false>,
+        ComponentStorage<HashListStorage<size_t, bool, false>>,
         DefaultIndexProvider<Person, size_t>
     > g;
 
@@ -69,53 +68,37 @@ int main() {
             << " }\n";
     }
 
-    auto start = g.const_access(g.find("A"));
-    auto dest = g.const_access(g.find("E"));
-
-    typedef decltype(start) __accessor;
-    std::unordered_map<const Person*, const Person*> previous;
-    std::unordered_set<size_t> visited;
-    std::queue<__accessor> q;
-    visited.insert(start.raw());
-    previous.emplace(&*start, nullptr);
-    q.emplace(start);
-
-    bool solved = false;
-    while(!q.empty()) {
-        auto& acc = q.front();
-        if (acc == dest) {
-            solved = true;
-            break;
-        }
-        acc.updateAdjacent(UpdateStrategy::forth);
-        auto ptr = &*acc;
-        for (auto [idx, vp, wp]: acc.listForth()) {
-            if (!visited.contains(idx)) {
-                previous.emplace(vp, ptr);
-                visited.emplace(idx);
-                q.push(acc.next(idx));
-            }
-        }
-        q.pop();
+    // influence ranking
+    auto ranks = algorithms::PageRank(g);
+    double rank_seconds = 0;
+    for (auto sec: ranks.iteration_seconds) rank_seconds += sec;
+    std::cout << "PageRank: " << ranks.iterations << " iterations, "
+        << rank_seconds * 1e6 / ranks.iterations << " us per iteration\n";
+    std::cout << "Most influential:";
+    for (auto idx: ranks.top(3)) {
+        std::cout << ' ' << g[idx].name << " (" << ranks.score[idx] << ')';
     }
+    std::cout << '\n';
 
-    if (!solved) {
+    auto start = g.find("A");
+    auto dest = g.find("E");
+
+    // union-find kept in sync with addEdge answers reachability directly
+    if (!g.storage().connected(start, dest)) {
         std::cout << "Can not reach!";
         return 0;
     }
 
-    const Person* walker = &*dest;
-    std::stack<const Person*> rev;
-    while (walker != nullptr) {
-        rev.push(walker);
-        walker = previous[walker];
-    }
+    // level-synchronous BFS, stops once the level holding dest is done
+    auto paths = algorithms::ParallelBFS(g, start, dest);
 
     std::cout << "START";
-    while (rev.size()) {
-        std::cout << " -> " << rev.top()->name ;
-        rev.pop();
+    for (auto idx: paths.pathTo(dest)) {
+        std::cout << " -> " << g[idx].name;
     }
+    // the same person has no one in between, and distance 0 would wrap around
+    size_t between = paths.distance[dest] == 0 ? 0 : paths.distance[dest] - 1;
+    std::cout << "\nPeople in between: " << between;
 
     return 0;
 }
\ No newline at end of file